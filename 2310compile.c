@@ -0,0 +1,156 @@
+#include "game.h"
+#include "site.h"
+#include "compiled.h"
+
+void usage(void);
+void compile_file(char* fileName);
+int compile_deck(char* text, CompiledHeader* header, char** body);
+int compile_path(char* text, CompiledHeader* header, char** body);
+void write_compiled(char* fileName, CompiledHeader* header, char* body, 
+	int bodySize);
+
+/*
+ * Compile each deck or path file given into a file of the same name 
+ * followed by COMPILED_SUFFIX, which the dealer, 2310sim and 2310tournament
+ * then load in place of the text for as long as the text is unchanged
+ * */
+int main(int argc, char** argv) {
+    int i;
+
+    if (argc < 2) {
+        usage();
+    }
+    for (i = 1; i < argc; i++) {
+        compile_file(argv[i]);
+    }
+
+    return 0;
+}
+
+/*
+ * Print the usage message and exit
+ * */
+void usage(void) {
+    fprintf(stderr, "Usage: 2310compile file {file}\n");
+    exit(1);
+}
+
+/*
+ * Validate a deck or path file and write out its compiled form
+ * A path is told apart from a deck by the ';' after its size
+ * Exit if the file cannot be read or is not a valid deck or path
+ * */
+void compile_file(char* fileName) {
+    struct stat info;
+    long long length;
+    char* text = map_file(fileName, &length);
+    char* end;
+    char* body;
+    int bodySize;
+
+    if (!text || stat(fileName, &info) < 0 || 
+	    is_compiled(text, COMPILED_DECK) || 
+	    is_compiled(text, COMPILED_PATH)) {
+        fprintf(stderr, "Error reading %s\n", fileName);
+        exit(2);
+    }
+
+    CompiledHeader header;
+    memset(&header, 0, sizeof(CompiledHeader));
+    memcpy(header.magic, COMPILED_MAGIC, strlen(COMPILED_MAGIC));
+    header.version = COMPILED_VERSION;
+    header.checksum = checksum(text, length);
+    header.sourceSize = info.st_size;
+    header.sourceSeconds = info.st_mtim.tv_sec;
+    header.sourceNanoseconds = info.st_mtim.tv_nsec;
+
+    strtol(text, &end, 10);
+    if (*end == ';') {
+        bodySize = compile_path(text, &header, &body);
+    } else {
+        bodySize = compile_deck(text, &header, &body);
+    }
+
+    write_compiled(fileName, &header, body, bodySize);
+    printf("%s: %d %s\n", fileName, header.count, 
+	    header.kind == COMPILED_DECK ? "cards" : "sites");
+}
+
+/*
+ * Check a deck and set the body of its compiled form to its cards
+ * Return the size of the body or exit if the deck is invalid
+ * */
+int compile_deck(char* text, CompiledHeader* header, char** body) {
+    int deckSize;
+
+    *body = check_deckfile(text, &deckSize);
+    header->kind = COMPILED_DECK;
+    header->count = deckSize;
+    return deckSize;
+}
+
+/*
+ * Check a path and set the body of its compiled form to the type of every 
+ * site, padded to the size of an int, followed by the limit of every site
+ * The number of players is not known yet, so '-' becomes EVERY_PLAYER and 
+ * the limits of the barriers are checked when the path is loaded
+ * Return the size of the body or exit if the path is invalid
+ * */
+int compile_path(char* text, CompiledHeader* header, char** body) {
+    int i, pathSize;
+    char dummy;
+
+    if (sscanf(text, "%d%c", &pathSize, &dummy) != 2 || pathSize < 1) {
+        fprintf(stderr, "Error reading path\n");
+        exit(3);
+    }
+    Site* sites = (Site*)malloc(sizeof(Site) * pathSize);
+    unsigned char* types = (unsigned char*)malloc(sizeof(unsigned char) * 
+	    pathSize);
+    if (!parse_sites(strchr(text, ';') + 1, sites, types, pathSize, 
+	    EVERY_PLAYER) || types[0] != SITE_BARRIER || 
+	    types[pathSize - 1] != SITE_BARRIER) {
+        fprintf(stderr, "Error reading path\n");
+        exit(3);
+    }
+
+    header->kind = COMPILED_PATH;
+    header->count = pathSize;
+    int* limits = compiled_limits(header);
+    int typesSize = (char*)limits - (char*)compiled_types(header);
+    *body = (char*)calloc(typesSize + sizeof(int) * pathSize, sizeof(char));
+    memcpy(*body, types, pathSize);
+    for (i = 0; i < pathSize; i++) {
+        ((int*)(*body + typesSize))[i] = sites[i].limit;
+    }
+
+    free(sites);
+    free(types);
+    return typesSize + sizeof(int) * pathSize;
+}
+
+/*
+ * Write the header and body to the compiled file for fileName, replacing 
+ * any earlier compiled file in one step so that a game starting at the 
+ * same time never sees half of it
+ * Exit if the file could not be written
+ * */
+void write_compiled(char* fileName, CompiledHeader* header, char* body, 
+	int bodySize) {
+    char* name = compiled_name(fileName);
+    char* temporary = (char*)malloc(sizeof(char) * (strlen(name) + 
+	    MAX_MSG_SIZE));
+    sprintf(temporary, "%s.%d", name, getpid());
+
+    FILE* out = fopen(temporary, "w");
+    if (!out || fwrite(header, sizeof(CompiledHeader), 1, out) != 1 || 
+	    fwrite(body, sizeof(char), bodySize, out) != bodySize || 
+	    fclose(out) != 0 || rename(temporary, name) < 0) {
+        fprintf(stderr, "Error writing %s\n", name);
+        unlink(temporary);
+        exit(4);
+    }
+
+    free(temporary);
+    free(name);
+}
@@ -1,5 +1,19 @@
 #include "dealer.h"
 #include "common.h"
+#include "protocol.h"
+#include "shared.h"
+#include "site.h"
+#include "compiled.h"
+#include "player.h"
+#include "stats.h"
+#include "profile.h"
+#include "trace.h"
+#include <poll.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/uio.h>
+#include <limits.h>
+#include <sys/resource.h>
 
 /*
  * Game struct used to clean up when SIGHUB is caught
@@ -7,29 +21,127 @@
 Game* sigHandler;
 
 int main(int argc, char** argv) {
-    if (argc < 4) {
-        fprintf(stderr, "Usage: 2310dealer deck path p1 {p2}\n");
+    int g, opt, timeout = -1, margin = EMPTY, games = 1;
+    bool binary = false, shared = false, compiled = false, profiling = false;
+    char* end, *statsName = NULL, *traceName = NULL;
+
+    while ((opt = getopt(argc, argv, "+bcg:l:pst:T:w:")) != -1) {
+        if (opt == 'b') {
+            binary = true;
+            continue;
+        } else if (opt == 'c') {
+            compiled = true;
+            continue;
+        } else if (opt == 'g') {
+            games = strtol(optarg, &end, 10);
+            if (*end == '\0' && games > 0) {
+                continue;
+            }
+        } else if (opt == 'l') {
+            statsName = optarg;
+            continue;
+        } else if (opt == 'p') {
+            profiling = true;
+            continue;
+        } else if (opt == 's') {
+            shared = true;
+            continue;
+        } else if (opt == 't') {
+            timeout = strtol(optarg, &end, 10);
+            if (*end == '\0' && timeout > 0) {
+                continue;
+            }
+        } else if (opt == 'T') {
+            traceName = optarg;
+            continue;
+        } else if (opt == 'w') {
+            margin = strtol(optarg, &end, 10);
+            if (*end == '\0' && margin >= 0) {
+                continue;
+            }
+        }
+        argc = 0;
+        break;
+    }
+    // Drop the options so that the deck is argv[1] as before
+    argv += optind - 1;
+    argc -= optind - 1;
+    // A trace holds one game, so it cannot follow a pool of them
+    if (argc < 4 || (traceName && games > 1)) {
+        fprintf(stderr, 
+		"Usage: 2310dealer [-b] [-c] [-g repeats] [-l stats] [-p] [-s] "
+		"[-t timeout] [-T trace] [-w margin] deck path p1 {p2}\n"
+		"-g plays the same deck and path repeats times, and not with -T\n");
         exit(1);
     }    
 
+    int deckSize;
+    Profile* profile = profiling ? create_profile() : NULL;
+    start_phase(profile, PHASE_READ);
     char* buffer1 = read_deckfile(argv[1]);
-    char* deck = check_deckfile(buffer1);
+    char* deck = check_deckfile(buffer1, &deckSize);
     char* buffer2 = read_pathfile(argv[2]);
+    end_phase(profile, PHASE_READ);
 
     Game* game = (Game*)malloc(sizeof(Game));
+    start_phase(profile, PHASE_SITES);
     Site* sites = create_sites(game, buffer2, argc);
-    initialise_game(game, deck, sites, argc);
+    end_phase(profile, PHASE_SITES);
+    initialise_game(game, deck, deckSize, sites, argc);
+    game->profile = profile;
+    game->timeout = timeout;
+    game->binary = binary;
+    game->newGames = games > 1;
+    if (compiled && is_compiled(buffer2, COMPILED_PATH)) {
+        game->compiledName = compiled_name(argv[2]);
+        // The path given was compiled already, rather than its text
+        if (access(game->compiledName, R_OK)) {
+            free(game->compiledName);
+            game->compiledName = strdup(argv[2]);
+        }
+    }
+    if (statsName) {
+        game->statsName = statsName;
+        game->latencies = (Latency*)calloc(game->numPlayers, 
+		sizeof(Latency));
+    }
+    if (traceName && !(game->trace = open_trace(traceName, game, 
+	    argv + PROGRAM_ARGS))) {
+        fprintf(stderr, "Error writing trace\n");
+    }
 
-    initialise_players(game, argv, buffer2);
     sigHandler = game;   
-    struct sigaction sighup;
-    memset(&sighup, 0, sizeof(sighup));
-    sighup.sa_handler = sighup_handler;
-    sigaction(SIGHUP, &sighup, NULL);
-    signal(SIGPIPE, SIG_IGN);
-
-    char** board = initialise_board(game);
-    play_game(board, game);
+    install_handlers(game);
+    raise_file_limit(game);
+    if (shared) {
+        share_state(game);
+    }
+    start_phase(profile, PHASE_PLAYERS);
+    initialise_players(game, argv, buffer2);
+    end_phase(profile, PHASE_PLAYERS);
+    // Every player has the region mapped now, so the name can go
+    remove_shared_name(game);
+
+    initialise_positions(game);
+    for (g = 0; g < games; g++) {
+        if (g > 0) {
+            start_phase(profile, PHASE_PLAYERS);
+            new_game(game);
+            end_phase(profile, PHASE_PLAYERS);
+        }
+        Board board;
+        initialise_board(&board, game->types, game->pathSize, 
+		game->numPlayers, stdout);
+        if (margin != EMPTY) {
+            set_viewport(&board, margin);
+        }
+        place_players(&board, game->sites, game->links);
+        play_game(&board, game);
+        free_board(&board);
+    }
+    if (profile) {
+        print_profile(profile, stderr);
+    }
 
     return 0;
 }
@@ -44,237 +156,116 @@ void sighup_handler(int signalNumber) {
 }
 
 /*
- * Shuts down all player processes when SIGHUP has been caught
+ * Handles SIGCHLD when it is caught by waking up the dealer's event loop
  * */
-void shut_down_players(Game* game) {
-    int i;
-   
-    for (i = 0; i < game->numPlayers; i++) {
-        int status;
-        waitpid(game->players[i].pid, &status, WNOHANG);
-        
-        if (!WIFEXITED(status)) {
-            kill(game->players[i].pid, SIGKILL);
-        }
-    }
-}
+void sigchld_handler(int signalNumber) {
+    int savedErrno = errno;
+    char wake = 0;
 
-/*
- * Parse the deckfile
- * Return the deckfile as a string on success or exit if there was an 
- * issue with the deckfile
- * */
-char* read_deckfile(char* fileName) {
-    FILE* in = fopen(fileName, "r");
-    if (!in) {
-        fprintf(stderr, "Error reading deck\n");
-        exit(2);
+    if (write(sigHandler->childPipe[STDOUT], &wake, 1) < 0) {
+        // The pipe is full, so a wake up is already pending
     }
-
-    fseek(in, 0, SEEK_END);
-    long length = ftell(in);
-    fseek(in, 0, SEEK_SET);
-
-    char* buffer = (char*)malloc(sizeof(char) * length + 1);
-    long offset = 0;    
-    if (buffer == NULL) {
-        fprintf(stderr, "Error reading deck\n");
-        exit(2);
-    }
-
-    while (!feof(in) && offset < length) {
-        offset += fread(buffer + offset, sizeof(char), length - offset, in);
-    }
-    buffer[offset - 1] = '\0';
-    fclose(in);
-
-    return buffer;
+    errno = savedErrno;
 }
 
 /*
- * Parse the pathfile
- * Return the contents of the pathfile as a string on success or exit if there 
- * was an issue with the pathfile
+ * Install the signal handlers and create the pipe that SIGCHLD uses to 
+ * wake up the dealer while it waits for players
+ * Exit if the pipe could not be created
  * */
-char* read_pathfile(char* fileName) {
-    FILE* in = fopen(fileName, "r");
-
-    if (!in) {
-        fprintf(stderr, "Error reading path\n");
-        exit(3);
+void install_handlers(Game* game) {
+    if (pipe(game->childPipe) < 0) {
+        fprintf(stderr, "Error starting process\n");
+        exit(4);
     }
+    fcntl(game->childPipe[STDIN], F_SETFL, O_NONBLOCK);
+    fcntl(game->childPipe[STDOUT], F_SETFL, O_NONBLOCK);
+    fcntl(game->childPipe[STDIN], F_SETFD, FD_CLOEXEC);
+    fcntl(game->childPipe[STDOUT], F_SETFD, FD_CLOEXEC);
 
-    fseek(in, 0, SEEK_END);
-    long length = ftell(in);
-    fseek(in, 0, SEEK_SET);
-
-    char* buffer = (char*)malloc(sizeof(char) * length + 1);
-    long offset = 0;
-    if (buffer == NULL) {
-        fprintf(stderr, "Error reading path\n");
-        exit(3);
-    }
+    struct sigaction sighup;
+    memset(&sighup, 0, sizeof(sighup));
+    sighup.sa_handler = sighup_handler;
+    sigaction(SIGHUP, &sighup, NULL);
 
-    while (!feof(in) && offset < length) {
-        offset += fread(buffer + offset, sizeof(char), length - offset, in);
-    }
-    buffer[offset] = '\0';
-    fclose(in);
+    struct sigaction sigchld;
+    memset(&sigchld, 0, sizeof(sigchld));
+    sigchld.sa_handler = sigchld_handler;
+    sigchld.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+    sigaction(SIGCHLD, &sigchld, NULL);
 
-    return buffer;
+    signal(SIGPIPE, SIG_IGN);
 }
 
 /*
- * Ensure that the contents of the deckfile are valid
- * Return the deck as a string on success or exit if the cards in the deck 
- * are invalid
+ * Raise the limit on open files as far as allowed if the dealer's two pipes
+ * to every player would not fit under it
  * */
-char* check_deckfile(char* buffer) {
-    int deckSize, i;
-    if (sscanf(buffer, "%d", &deckSize) != 1) {
-        fprintf(stderr, "Error reading deck\n");
-        exit(2);
-    }
- 
-    char* deck = (char*)malloc(sizeof(char) * deckSize);
-    strncpy(deck, buffer + 1, deckSize);
-    for (i = 0; i < deckSize; i++) {
-        if (deck[i] != 'A' && deck[i] != 'B' && deck[i] != 'C' && 
-		deck[i] != 'D' && deck[i] != 'E') {
-            fprintf(stderr, "Error reading deck\n");
-            exit(2);
-        }
-    }
+void raise_file_limit(Game* game) {
+    struct rlimit limit;
 
-    return deck;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && 
+	    limit.rlim_cur < 2 * game->numPlayers + 16 && 
+	    limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
 }
 
 /*
- * Ensure that the contents of the pathfile are valid and create the sites 
- * in the path
- * Return an array of the sites on success or exit if the sites are invalid
+ * Shuts down all player processes when SIGHUP has been caught or the game 
+ * has ended early
  * */
-Site* create_sites(Game* game, char* buffer, int argc) {
-    int pathSize, i = 0, j = 0, k, count = 1;
-    char dummy;
-    if (sscanf(buffer, "%d%c", &pathSize, &dummy) != 2 || dummy != ';') {
-        fprintf(stderr, "Error reading path\n");
-        exit(3);
-    }
+void shut_down_players(Game* game) {
+    int i;
 
-    if (pathSize > 9) {
-        count += 2;
-    } else {
-        count++;
-    }
-
-    Site* sites = (Site*)malloc(sizeof(Site) * pathSize);
-    for (i = count; i < pathSize * SITE_SIZE + count; i += SITE_SIZE) {
-        Site site;
-        char* siteType = (char*)malloc(sizeof(char) * TYPE_SIZE);
-        strncpy(siteType, buffer + i, TYPE_SIZE);
-        site.type = siteType;
-        site.type[TYPE_SIZE] = '\0';
-        if (buffer[i + TYPE_SIZE] == '-' || (buffer[i + TYPE_SIZE] - '0') > 
-		(argc - PROGRAM_ARGS)) {
-            site.limit = argc - PROGRAM_ARGS;
-        } else {
-            site.limit = buffer[i + TYPE_SIZE] - '0';
-        }
-        site.players = (char*)malloc(sizeof(char) * site.limit);
-        for (k = 0; k < site.limit; k++) {
-            site.players[k] = ' ';
+    remove_shared_name(game);
+    for (i = 0; i < game->numPlayers; i++) {
+        int status;
+        if (game->processes[i].pid > 0 && 
+		waitpid(game->processes[i].pid, &status, WNOHANG) == 0) {
+            kill(game->processes[i].pid, SIGKILL);
         }
-        sites[j] = site;
-        j++;
-    }
-
-    if (!valid_path(game, sites, pathSize, argc)) {
-        fprintf(stderr, "Error reading path\n");
-        exit(3);
     }
-
-    game->pathSize = pathSize;
-    return sites;
 }
 
 /*
- * Check to see if the path is valid
- * Returns true if the path is valid and false if it is invalid
+ * End the game early after a player has died, timed out or sent an 
+ * invalid message
+ * Tell the remaining players with EARLY, shut them down and exit
  * */
-bool valid_path(Game* game, Site* sites, int pathSize, int argc) {
+void end_game_early(Game* game) {
     int i;
 
-    for (i = 0; i < pathSize; i++) {
-        if ((strcmp(sites[i].type, "::") && strcmp(sites[i].type, "Mo") &&
-		strcmp(sites[i].type, "V1") && strcmp(sites[i].type, "V2") &&
-		strcmp(sites[i].type, "Do") && strcmp(sites[i].type, "Ri")) ||
-		!isdigit(sites[i].limit + '0')) {
-            return false;
-        }          
+    for (i = 0; i < game->numPlayers; i++) {
+        if (game->processes[i].in) {
+            send_message(game, EARLY, game->processes[i].in, 0, 0, 0, 0, 0);
+        }
     }
-
-    if (strcmp(sites[0].type, "::") || strcmp(sites[pathSize - 1].type, "::") 
-	    || sites[0].limit != argc - PROGRAM_ARGS || 
-	    sites[pathSize - 1].limit != argc - PROGRAM_ARGS) {
-        return false;
+    shut_down_players(game);
+    save_stats(game);
+    save_trace(game);
+    if (game->profile) {
+        print_profile(game->profile, stderr);
     }
-
-    return true;
-}
-
-/*
- * Initialise the structure members of the game
- * */
-void initialise_game(Game* game, char* deck, Site* sites, int argc) {
-    game->sites = sites;
-    game->deck = deck;
-    game->numPlayers = argc - PROGRAM_ARGS;
-    game->players = (Player*)malloc(sizeof(Player) * game->numPlayers);
-    game->sighup = false;
+    fprintf(stderr, "Communications error\n");
+    exit(5);
 }
 
 /*
  * Send a message to a player to prompt them for a move, let them know 
  * when a move has occurred or when the game is over
  * */
-void send_message(DealerMessage message, FILE* stream, int id, int site, 
-	int points, int money, int card) {
-    switch (message) {
-        case YT:
-            fprintf(stream, "YT\n");
-            break;
-        case EARLY:
-            fprintf(stream, "EARLY\n");
-            break;
-        case DONE:
-            fprintf(stream, "DONE\n");
-            break;
-        case HAP:
-            fprintf(stream, "HAP%d,%d,%d,%d,%d\n", id, site, points, 
-		    money, card);
-            break;
-    }
+void send_message(Game* game, DealerMessage message, FILE* stream, int id, 
+	int site, int points, int money, int card) {
+    Frame frame = {message, card, 0, id, site, points, money};
+    char buffer[MAX_MSG_SIZE];
+    int length = encode_message(&frame, game->binary, buffer);
 
+    fwrite(buffer, sizeof(char), length, stream);
     fflush(stream);
 }
 
-/*
- * Initialise the values for each member of the player struct
- * */
-void assign_player_values(Player* player) {
-    player->position = 0;
-    player->money = 7;
-    player->v1 = 0;
-    player->v2 = 0;        
-    player->points = 0;
-    player->a = 0;
-    player->b = 0;
-    player->c = 0;
-    player->d = 0;
-    player->e = 0;
-}
-
 /* 
  * Create the child process and initialise the structure members of the players
  * Exit if there was an issue starting a child process
@@ -289,65 +280,263 @@ void initialise_players(Game* game, char** argv, char* path) {
             exit(4);
         }
 
-        Player player;
-        player.id = i;
-        assign_player_values(&player);
-        player.pid = fork();
-        if (player.pid < 0) {
+        Process process;
+        process.in = NULL;
+        process.out = NULL;
+        process.inbox = (char*)malloc(sizeof(char) * MAX_MSG_SIZE);
+        process.received = 0;
+        process.delivered = 0;
+        // Keep the dealer's ends out of players started after this one
+        fcntl(playerIn[STDOUT], F_SETFD, FD_CLOEXEC);
+        fcntl(playerOut[STDIN], F_SETFD, FD_CLOEXEC);
+        process.pid = fork();
+        if (process.pid < 0) {
             fprintf(stderr, "Error starting process\n");
             exit(4);
-        } else if (player.pid == 0) {
+        } else if (process.pid == 0) {
             //child
             close(playerIn[STDOUT]);
             dup2(playerIn[STDIN], STDIN);
             close(playerOut[STDIN]);
             dup2(playerOut[STDOUT], STDOUT);
             dup2(open("/dev/null", O_WRONLY), STDERR);
-            char numPlayers[3], id[3];
+            char numPlayers[MAX_MSG_SIZE], id[MAX_MSG_SIZE];
             sprintf(numPlayers, "%d", game->numPlayers);
             sprintf(id, "%d", i);
             execlp(argv[i + PROGRAM_ARGS], argv[i + PROGRAM_ARGS], 
 		    numPlayers, id, NULL);
+            _exit(1);
         } else {
             //parent
             close(playerIn[STDIN]);
             close(playerOut[STDOUT]);
 
-            player.in = fdopen(playerIn[STDOUT], "w");
-            player.out = fdopen(playerOut[STDIN], "r");
+            process.in = fdopen(playerIn[STDOUT], "w");
+            process.out = fdopen(playerOut[STDIN], "r");
 
-            if (!player.in || !player.out) {
+            if (!process.in || !process.out) {
                 fprintf(stderr, "Error starting process\n");
                 exit(4);
             }
 
-            if (fgetc(player.out) != '^') {
+            game->processes[i] = process;
+            if (!receive_handshake(game, i) || !negotiate(game, i)) {
                 fprintf(stderr, "Error starting process\n");
+                shut_down_players(game);
                 exit(4);
             }
-            send_path(game, player.in);
+            if (!game->compiledName) {
+                start_phase(game->profile, PHASE_PATH);
+                send_path(game, process.in);
+                end_phase(game->profile, PHASE_PATH);
+            }
+        }
+    }
+}
+
+/*
+ * Read a single byte from a player, waiting no longer than the deadline
+ * Return true if a byte was read and false otherwise
+ * */
+bool read_byte(Game* game, int id, char* c) {
+    struct pollfd fd = {fileno(game->processes[id].out), POLLIN, 0};
+    int ready;
+
+    while ((ready = poll(&fd, 1, game->timeout)) < 0 && errno == EINTR) {
+    }
+
+    return ready > 0 && read(fd.fd, c, 1) == 1;
+}
+
+/*
+ * Wait for the '^' that a player sends once it has started
+ * Return true if it arrived before the deadline and false otherwise
+ * */
+bool receive_handshake(Game* game, int id) {
+    char c;
+    return read_byte(game, id, &c) && c == '^';
+}
+
+/*
+ * Offer the binary protocol, new games, shared state and the compiled path 
+ * to a player if they were requested, before the path is sent
+ * Return true if the player accepted everything offered and false otherwise
+ * */
+bool negotiate(Game* game, int id) {
+    char c;
+
+    if (game->binary) {
+        fprintf(game->processes[id].in, BINARY_OFFER);
+        fflush(game->processes[id].in);
+        if (!read_byte(game, id, &c) || c != BINARY_ACCEPT) {
+            return false;
+        }
+    }
+    if (game->newGames) {
+        fprintf(game->processes[id].in, NEWGAME_OFFER);
+        fflush(game->processes[id].in);
+        if (!read_byte(game, id, &c) || c != NEWGAME_ACCEPT) {
+            return false;
+        }
+    }
+    if (game->shared) {
+        fprintf(game->processes[id].in, SHARED_OFFER "%s\n", game->sharedName);
+        fflush(game->processes[id].in);
+        if (!read_byte(game, id, &c) || c != SHARED_ACCEPT) {
+            return false;
+        }
+    }
+    if (game->compiledName) {
+        fprintf(game->processes[id].in, COMPILED_OFFER "%s\n", 
+		game->compiledName);
+        fflush(game->processes[id].in);
+        if (!read_byte(game, id, &c) || c != COMPILED_ACCEPT) {
+            return false;
         }
-        game->players[i] = player;
     }
+
+    return true;
+}
+
+/*
+ * Move the game state into a shared memory region that players can map
+ * read only, in place of replaying HAP messages
+ * Exit if the region could not be created
+ * */
+void share_state(Game* game) {
+    char name[MAX_MSG_SIZE];
+
+    sprintf(name, "/2310dealer.%d", getpid());
+    game->shared = create_shared_state(name, game->numPlayers, 
+	    game->pathSize);
+    if (!game->shared) {
+        fprintf(stderr, "Error starting process\n");
+        exit(4);
+    }
+    game->sharedName = strdup(name);
+
+    memcpy(shared_types(game->shared), game->types, game->pathSize);
+
+    // The dealer updates the players, sites and links in place from now on
+    int* fields = shared_players(game->shared);
+    memcpy(fields, game->players.position, sizeof(int) * PLAYER_FIELDS * 
+	    game->numPlayers);
+    free_players(&game->players);
+    attach_players(&game->players, fields, game->numPlayers);
+    Site* sites = shared_sites(game->shared);
+    memcpy(sites, game->sites, sizeof(Site) * game->pathSize);
+    free(game->sites);
+    game->sites = sites;
+    free(game->links);
+    game->links = shared_links(game->shared);
+}
+
+/*
+ * Remove the name of the shared state so that it is freed once every 
+ * process has exited
+ * */
+void remove_shared_name(Game* game) {
+    if (game->sharedName) {
+        shm_unlink(game->sharedName);
+        free(game->sharedName);
+        game->sharedName = NULL;
+    }
+}
+
+/*
+ * Give the dealer its own copy of the players again once the game is over,
+ * so that the final scores are not added to the points in the shared state
+ * that each player adds them to itself
+ * */
+void unshare_players(Game* game) {
+    Players shared = game->players;
+
+    create_players(&game->players, game->numPlayers);
+    copy_players(&game->players, &shared, game->numPlayers);
+}
+
+/*
+ * Carry out a player's move and let the other players know about it, either
+ * by publishing it in the shared state or by queueing a HAP message
+ * */
+void make_move(Game* game, int id, int site, int* move) {
+    if (game->shared) {
+        begin_write(game->shared);
+        handle_move(game, site, id, move);
+        end_write(game->shared);
+    } else {
+        handle_move(game, site, id, move);
+        queue_message(game, HAP, id, site, move[0], move[1], move[2]);
+    }
+    trace_turn(game->trace, id, site, move);
 }
 
 /*
  * Send the path to a player
+ * A site that every player can fit on is sent as '-' so that its limit 
+ * stays a single character however many players there are
  * */
 void send_path(Game* game, FILE* stream) {
-    int i;
-    char* buffer = (char*)malloc(sizeof(char) * game->pathSize * 
-	    SITE_SIZE + 3);
-    sprintf(buffer, "%d;", game->pathSize);
+    int i, length;
+    char* buffer = (char*)malloc(sizeof(char) * (game->pathSize * 
+	    (TYPE_SIZE + 12) + 12));
+    length = sprintf(buffer, "%d;", game->pathSize);
 
     for (i = 0; i < game->pathSize; i++) {
-        sprintf(buffer + strlen(buffer), "%c%c%d", game->sites[i].type[0], 
-		game->sites[i].type[1], game->sites[i].limit);
+        if (game->sites[i].limit == game->numPlayers) {
+            length += sprintf(buffer + length, "%s-", 
+		    siteNames[game->types[i]]);
+        } else {
+            length += sprintf(buffer + length, "%s%d", 
+		    siteNames[game->types[i]], game->sites[i].limit);
+        }
     }
-    buffer[game->pathSize * SITE_SIZE + 3] = '\0';
     fprintf(stream, "%s\n", buffer);
 
     fflush(stream);
+    free(buffer);
+}
+
+/*
+ * Start another game with the same players once the last one is over
+ * Every player is sent NEWGAME and answers with '^' once it has finished 
+ * with the last game, so that the game is only put back to its start 
+ * after that, and then the path is sent again unless it is compiled
+ * Exit if a player does not answer
+ * */
+void new_game(Game* game) {
+    int i;
+
+    // Every message in the log went out with DONE
+    game->logSize = 0;
+    for (i = 0; i < game->numPlayers; i++) {
+        game->processes[i].delivered = 0;
+        deliver_messages(game, i, NEWGAME);
+    }
+    for (i = 0; i < game->numPlayers; i++) {
+        if (!receive_handshake(game, i)) {
+            fprintf(stderr, "Error starting process\n");
+            shut_down_players(game);
+            exit(4);
+        }
+    }
+
+    if (game->shared) {
+        free_players(&game->players);
+        attach_players(&game->players, shared_players(game->shared), 
+		game->numPlayers);
+        begin_write(game->shared);
+    }
+    reset_game(game);
+    if (game->shared) {
+        end_write(game->shared);
+    }
+
+    for (i = 0; !game->compiledName && i < game->numPlayers; i++) {
+        start_phase(game->profile, PHASE_PATH);
+        send_path(game, game->processes[i].in);
+        end_phase(game->profile, PHASE_PATH);
+    }
 }
 
 /*
@@ -356,360 +545,343 @@ void send_path(Game* game, FILE* stream) {
  * Alert all players when a move has occurred and print the board
  * Print the scores when the game is over and alert players
  * */
-void play_game(char** board, Game* game) {
-    int i;
+void play_game(Board* board, Game* game) {
+    int i, move[3];
 
-    display_board(board, game);
+    // Flush when the game starts and ends so that a reader of the output 
+    // can tell how long the turns took
+    start_phase(game->profile, PHASE_RENDER);
+    display_board(board);
+    fflush(stdout);
+    end_phase(game->profile, PHASE_RENDER);
 
+    start_phase(game->profile, PHASE_TURNS);
     while (!game_over(game)) {
-        // Find player who is furthest behind
-        int last = game->players[0].position, pID = 0;
-        for (i = 1; i < game->numPlayers; i++) {
-            if (game->players[i].position < last) {
-                last = game->players[i].position;
-                pID = i;
-            }
-        }
-
-        for (i = game->sites[last].limit - 1; i >= 0; i--) {
-            if (game->sites[last].players[i] == pID + '0') {
-                break;
-            }
-            if (game->sites[last].players[i] != ' ' && 
-		    game->sites[last].players[i] - '0' != pID) {
-                pID = game->sites[last].players[i] - '0';
-                break;
-            }
-        }
-
-        send_message(YT, game->players[pID].in, pID, 0, 0, 0, 0);
+        int pID = next_player(game);
+        deliver_messages(game, pID, YT);
+        long long sent = game->latencies ? clock_ns() : 0;
         int site = receive_message(game, pID);
-        int* move = handle_move(game, site, pID);
-        printf("Player %d Money=%d V1=%d V2=%d Points=%d A=%d B=%d C=%d "
-		"D=%d E=%d\n", pID, game->players[pID].money, 
-		game->players[pID].v1, game->players[pID].v2, 
-		game->players[pID].points, game->players[pID].a, 
-		game->players[pID].b, game->players[pID].c, 
-		game->players[pID].d, game->players[pID].e);
-        update_board(board, game);
-        for (i = 0; i < game->numPlayers; i++) {
-            send_message(HAP, game->players[i].in, pID, site, move[0], 
-		    move[1], move[2]);
+        if (game->latencies) {
+            record_latency(&game->latencies[pID], clock_ns() - sent);
         }
+        int from = game->players.position[pID];
+        make_move(game, pID, site, move);
+        start_phase(game->profile, PHASE_RENDER);
+        printf("Player %d Money=%d V1=%d V2=%d Points=%d A=%d B=%d C=%d "
+		"D=%d E=%d\n", pID, game->players.money[pID], 
+		game->players.v1[pID], game->players.v2[pID], 
+		game->players.points[pID], game->players.a[pID], 
+		game->players.b[pID], game->players.c[pID], 
+		game->players.d[pID], game->players.e[pID]);
+        move_on_board(board, game->sites, game->links, from, site);
+        display_board(board);
+        end_phase(game->profile, PHASE_RENDER);
     }
+    end_phase(game->profile, PHASE_TURNS);
 
+    start_phase(game->profile, PHASE_SCORES);
+    if (game->shared) {
+        unshare_players(game);
+    }
     print_scores(game);
+    fflush(stdout);
+    end_phase(game->profile, PHASE_SCORES);
+    save_stats(game);
+    save_trace(game);
 
+    start_phase(game->profile, PHASE_SHUTDOWN);
     for (i = 0; i < game->numPlayers; i++) {
-        send_message(DONE, game->players[i].in, 0, 0, 0, 0, 0);
+        deliver_messages(game, i, DONE);
     }
+    end_phase(game->profile, PHASE_SHUTDOWN);
 }
 
 /*
- * Receive a message from a player
- * On success, return the site that the player has chosen to move to
+ * Write how long each player took to answer YT to the stats file, if one 
+ * was asked for
  * */
-int receive_message(Game* game, int id) {
-    long long n = game->pathSize;
-    int c, i = 0, site, count = 0;
-    while (n != 0) {
-        n /= 10;
-        ++count;
-    }
-
-    char* buffer = (char*)malloc(sizeof(char) * (count + 3));
-    char dummy1, dummy2;
-
-    while (c = fgetc(game->players[id].out), c != '\n' && c != EOF) {
-        buffer[i] = c;
-        i++;
-    }
-    buffer[count + 2] = '\0';
-
-    sscanf(buffer, "%c%c%d", &dummy1, &dummy2, &site);
-
-/*
-    if (sscanf(buffer, "%c%c%d", &dummy1, &dummy2, &site) != 3) {
-        fprintf(stderr, "Communications error\n");
-        exit(5);
-    }
-*/
-    return site;
-}
-
-/*
- * Carry out a move when a player has chosen their next site
- * Update the structure members of the players depending on the site they 
- * move to
- * Return an array of the values for members to be changed for that player
- * */
-int* handle_move(Game* game, int site, int id) {
-    int* move = (int*)malloc(sizeof(int) * 3);
-    if (!strcmp(game->sites[site].type, "Mo")) {
-        move[0] = 0;
-        move[1] = 3;
-        move[2] = 0;
-        game->players[id].money += 3;
-    } else if (!strcmp(game->sites[site].type, "V1")) {
-        move[0] = 0;
-        move[1] = 0;
-        move[2] = 0;
-        game->players[id].v1++;
-    } else if (!strcmp(game->sites[site].type, "V2")) {
-        move[0] = 0;
-        move[1] = 0;
-        move[2] = 0;
-        game->players[id].v2++;
-    } else if (!strcmp(game->sites[site].type, "Do")) {
-        move[0] = game->players[id].money / 2;
-        move[1] = -game->players[id].money;
-        move[2] = 0;
-        game->players[id].points += game->players[id].money / 2;
-        game->players[id].money = 0;
-    } else if (!strcmp(game->sites[site].type, "Ri")) {
-        move[0] = 0;
-        move[1] = 0;
-        if (game->deck[0] == 'A') {
-            move[2] = 1;
-            game->players[id].a++;
-        } else if (game->deck[0] == 'B') {
-            move[2] = 2;
-            game->players[id].b++;
-        } else if (game->deck[0] == 'C') {
-            move[2] = 3;
-            game->players[id].c++;
-        } else if (game->deck[0] == 'D') {
-            move[2] = 4;
-            game->players[id].d++;
-        } else {
-            move[2] = 5;
-            game->players[id].e++;
-        }
-        shift_deck(game);
-    } else {
-        move[0] = 0;
-        move[1] = 0;
-        move[2] = 0;
+void save_stats(Game* game) {
+    if (game->latencies && !write_stats(game->statsName, game->latencies, 
+	    game->numPlayers)) {
+        fprintf(stderr, "Error writing stats\n");
     }
-    shift_site_players(game, id, site);
-    return move;
 }
 
 /*
- * Remove the player with the specified ID from one site and add them
- * to the site that they would like to move to
+ * Write out the rest of the trace of the game, if one was asked for
  * */
-void shift_site_players(Game* game, int id, int nextSite) {
-    int i, j, currentSite = game->players[id].position;
-
-    for (i = 0; i < game->sites[currentSite].limit; i++) {
-        if (game->sites[currentSite].players[i] == id + '0') {
-            for (j = i; j < game->sites[currentSite].limit; j++) {
-                game->sites[currentSite].players[j] =
-                        game->sites[currentSite].players[j + 1];
-            }
-            game->sites[currentSite].players[game->sites[currentSite].limit
-                    - 1] = ' ';
-        }
+void save_trace(Game* game) {
+    if (game->trace && !close_trace(game->trace)) {
+        fprintf(stderr, "Error writing trace\n");
     }
+    game->trace = NULL;
+}
+
+/*
+ * Format a message once and add it to the log of messages that every 
+ * player is sent
+ * Players are only sent the log when they next need to act, so each turn
+ * costs one write rather than one per player
+ * A player that is not prompted for a long while, such as one with no 
+ * turns left, is sent its part of the log on its own once that would not 
+ * fit in one atomic pipe write, which keeps the log and the writes at DONE 
+ * small
+ * */
+void queue_message(Game* game, DealerMessage message, int id, int site, 
+	int points, int money, int card) {
+    Frame frame = {message, card, 0, id, site, points, money};
+    int i;
 
-    for (i = 0; i < game->sites[nextSite].limit; i++) {
-        if (game->sites[nextSite].players[i] == ' ') {
-            game->sites[nextSite].players[i] = id + '0';
-            break;
+    for (i = 0; i < game->numPlayers; i++) {
+        if (game->logSize - game->processes[i].delivered + MAX_MSG_SIZE > 
+		PIPE_BUF) {
+            flush_messages(game, i);
         }
     }
+    if (game->logSize + MAX_MSG_SIZE > game->logCapacity) {
+        trim_log(game);
+    }
+    if (game->logSize + MAX_MSG_SIZE > game->logCapacity) {
+        game->logCapacity = game->logCapacity * 2 + MAX_MSG_SIZE;
+        game->log = (char*)realloc(game->log, game->logCapacity);
+    }
+    game->logSize += encode_message(&frame, game->binary, 
+	    game->log + game->logSize);
+}
 
-    game->players[id].position = nextSite;
+/*
+ * Send a player every logged message it has not yet seen followed by 
+ * message, all in a single write
+ * */
+void deliver_messages(Game* game, int id, DealerMessage message) {
+    Process* process = &game->processes[id];
+    Frame frame = {message, 0, 0, id, 0, 0, 0};
+    char buffer[MAX_MSG_SIZE];
+    struct iovec parts[2];
+
+    parts[0].iov_base = game->log + process->delivered;
+    parts[0].iov_len = game->logSize - process->delivered;
+    parts[1].iov_base = buffer;
+    parts[1].iov_len = encode_message(&frame, game->binary, buffer);
+    process->delivered = game->logSize;
+    write_parts(process, parts, 2);
 }
 
 /*
- * Shift the deck once a card has been drawn
+ * Send a player every logged message it has not yet seen, without asking
+ * anything of it
  * */
-void shift_deck(Game* game) {
-    int i, deckSize = (sizeof(game->deck) / sizeof(char)) - 1;
-    char first = game->deck[0];
+void flush_messages(Game* game, int id) {
+    Process* process = &game->processes[id];
+    struct iovec part;
+
+    part.iov_base = game->log + process->delivered;
+    part.iov_len = game->logSize - process->delivered;
+    process->delivered = game->logSize;
+    write_parts(process, &part, 1);
+}
 
-    for (i = 0; i < deckSize; i++) {
-        game->deck[i] = game->deck[i + 1];
+/*
+ * Write all of parts to a player, going on from wherever the pipe stopped
+ * if it only took some of them
+ * Write errors are left for wait_for_message to notice as a dead player
+ * */
+void write_parts(Process* process, struct iovec* parts, int count) {
+    int part = 0;
+
+    while (part < count) {
+        ssize_t sent = writev(fileno(process->in), parts + part, 
+		count - part);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        } else if (sent < 0) {
+            return;
+        }
+        // Skip past whatever was written if the pipe only took part of it
+        while (part < count && sent >= parts[part].iov_len) {
+            sent -= parts[part].iov_len;
+            part++;
+        }
+        if (part < count) {
+            parts[part].iov_base = (char*)parts[part].iov_base + sent;
+            parts[part].iov_len -= sent;
+        }
     }
-    game->deck[deckSize - 1] = first;
 }
 
 /*
- * Initialise the board and positions for the game
+ * Drop the messages at the start of the log that every player has already
+ * been sent
  * */
-char** initialise_board(Game* game) {
-    int r, c;
-    char** board = (char**)malloc(sizeof(char*) * game->numPlayers);
+void trim_log(Game* game) {
+    int i, seen = game->logSize;
 
-    for (r = 0; r < game->numPlayers; r++) {
-        board[r] = (char*)malloc(sizeof(char) * (game->pathSize * 
-	        SITE_SIZE + 1));
-        for (c = 0; c < game->pathSize * SITE_SIZE + 1; c++) {
-            if (c == game->pathSize * SITE_SIZE) {
-                board[r][c] = '\n';
-            } else {
-                board[r][c] = ' ';
-            }
+    for (i = 0; i < game->numPlayers; i++) {
+        if (game->processes[i].delivered < seen) {
+            seen = game->processes[i].delivered;
         }
     }
-
-    char player = (game->numPlayers - 1) + '0';
-    for (r = 0; r < game->numPlayers; r++) {
-        game->sites[0].players[r] = player;
-        board[r][0] = player;
-        player--;
+    if (seen == 0) {
+        return;
+    }
+    memmove(game->log, game->log + seen, game->logSize - seen);
+    game->logSize -= seen;
+    for (i = 0; i < game->numPlayers; i++) {
+        game->processes[i].delivered -= seen;
     }
-
-    return board;
 }
 
 /*
- * Once a move has been made, update the positions of the players 
- * on the board
+ * Return the current time in milliseconds
  * */
-void update_board(char** board, Game* game) {
-    int i = 0, r, c, j;
-
-    for (r = 0; r < game->numPlayers; r++) {
-        for (c = 0; c < game->pathSize * SITE_SIZE + 1; c++) {
-            if (c == game->pathSize * SITE_SIZE) {
-                board[r][c] = '\n';
-            } else {
-                board[r][c] = ' ';
-            }
-        }
-    }
+long long now_ms(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000LL + now.tv_nsec / 1000000;
+}
 
-    for (i = 0; i < game->pathSize; i++) {
-        if (game->sites[i].players[0] != ' ') {
-            for (j = 0; j < game->sites[i].limit; j++) {
-                board[j][i * SITE_SIZE] = game->sites[i].players[j];
-            }
-        }
+/*
+ * Check to see if a whole message is waiting in a player's inbox
+ * Return the number of bytes in the message or 0 if it is incomplete
+ * */
+int message_waiting(Game* game, Process* process) {
+    if (game->binary) {
+        return process->received >= sizeof(Frame) ? sizeof(Frame) : 0;
     }
 
-    display_board(board, game);
+    char* newline = memchr(process->inbox, '\n', process->received);
+    return newline ? newline - process->inbox + 1 : 0;
 }
 
 /*
- * Print the board and the path
+ * Read whatever a player has sent into its inbox
+ * Return false if the player has closed its end of the pipe or sent a 
+ * message that is too long and true otherwise
  * */
-void display_board(char** board, Game* game) {
-    int i, r, c, count = 0;
+bool fill_inbox(Game* game, Process* process) {
+    ssize_t got = read(fileno(process->out), process->inbox + 
+	    process->received, MAX_MSG_SIZE - process->received);
 
-    for (r = 0; r < game->numPlayers; r++) {
-        for (c = 0; c < game->pathSize * SITE_SIZE; c++) {
-            if (board[r][c] != ' ' && board[r][c] != '\n') {
-                count++;
-                break;
-            }
-        }
+    if (got < 0) {
+        return errno == EINTR || errno == EAGAIN;
     }
+    process->received += got;
+    return got > 0 && (process->received < MAX_MSG_SIZE || 
+	    message_waiting(game, process));
+}
 
-    for (i = 0; i < game->pathSize; i++) {
-        if (i == game->pathSize - 1) {
-            printf("%s \n", game->sites[i].type);
-        } else {
-            printf("%s ", game->sites[i].type);
-        }
+/*
+ * Take one message from a player's inbox if a whole message has arrived
+ * A message that cannot be parsed is given the type BAD_MESSAGE
+ * Return true and fill in frame, or return false if no complete message 
+ * is waiting
+ * */
+bool take_message(Game* game, Process* process, Frame* frame) {
+    int length = message_waiting(game, process);
+    if (!length) {
+        return false;
     }
 
-    for (r = 0; r < count; r++) {
-        for (c = 0; c < game->pathSize * SITE_SIZE + 1; c++) {
-            printf("%c", board[r][c]);
+    if (game->binary) {
+        memcpy(frame, process->inbox, sizeof(Frame));
+        if (!valid_frame(frame)) {
+            frame->type = BAD_MESSAGE;
         }
+    } else {
+        char line[MAX_MSG_SIZE];
+        memcpy(line, process->inbox, length - 1);
+        line[length - 1] = '\0';
+        decode_line(line, frame);
     }
+    process->received -= length;
+    memmove(process->inbox, process->inbox + length, process->received);
+    return true;
 }
 
 /*
- * Check to see if the game is over
- * Return true if all players are at the last site or false if the game 
- * is still running
- * */   
-bool game_over(Game* game) {
-    int i;
+ * Reap any player that has exited
+ * Return true if a player died while the game was still running
+ * */
+bool player_died(Game* game) {
+    char drain[64];
+    int i, status;
 
+    while (read(game->childPipe[STDIN], drain, sizeof(drain)) > 0) {
+    }
     for (i = 0; i < game->numPlayers; i++) {
-        if (game->players[i].position != game->pathSize - 1) {
-            return false;
+        if (game->processes[i].pid > 0 && 
+		waitpid(game->processes[i].pid, &status, WNOHANG) > 0) {
+            game->processes[i].pid = 0;
+            return true;
         }
     }
 
-    return true;
+    return false;
 }
 
 /*
- * Calculate and print the scores of for each player at the end of the game
+ * Wait for a message from the player with the specified ID while watching 
+ * the pipes of every player and the SIGCHLD pipe
+ * Messages that arrive from other players are kept in their inboxes
+ * Return true once a message has been copied into frame, or false if the 
+ * deadline passed, a player died or a player closed its pipe
  * */
-void print_scores(Game* game) {
-    int i;
+bool wait_for_message(Game* game, int id, Frame* frame) {
+    int i, ready, numFds = game->numPlayers + 1;
+    long long deadline = now_ms() + game->timeout;
+    struct pollfd* fds = game->pollFds;
+
+    while (!take_message(game, &game->processes[id], frame)) {
+        int wait = -1;
+        if (game->timeout > 0) {
+            wait = deadline - now_ms();
+            if (wait <= 0) {
+                return false;
+            }
+        }
 
-    printf("Scores: ");
-    for (i = 0; i < game->numPlayers; i++) {
-        int cardScore = card_score(game, i);
-        game->players[i].points += (game->players[i].v1 + game->players[i].v2 
-		+ cardScore);
-        if (i == game->numPlayers - 1) {
-            printf("%d\n", game->players[i].points);
-        } else {
-            printf("%d,", game->players[i].points);
+        fds[0].fd = game->childPipe[STDIN];
+        fds[0].events = POLLIN;
+        for (i = 0; i < game->numPlayers; i++) {
+            fds[i + 1].fd = fileno(game->processes[i].out);
+            fds[i + 1].events = POLLIN;
+        }
+        ready = poll(fds, numFds, wait);
+        if (ready < 0 && errno != EINTR) {
+            return false;
+        }
+        if (ready <= 0) {
+            continue;
         }
-    }
-}
 
-/*
- * Calculate the points that a player gains from the cards that they have
- * Return the points that they gain
- * */
-int card_score(Game* game, int id) {
-    int i, j, score = 0, a = game->players[id].a, b = game->players[id].b, 
-	    c = game->players[id].c, d = game->players[id].d, 
-	    e = game->players[id].e;
-    char cards[5] = {a, b, c, d, e};
-    for (i = 0; i < 5; i++) {
-        for (j = i + 1; j < 5; j++) {
-            if (cards[j] > cards[i]) {
-                int tmp = cards[i];
-                cards[i] = cards[j];
-                cards[j] = tmp;
+        if ((fds[0].revents & POLLIN) && player_died(game)) {
+            return false;
+        }
+        for (i = 0; i < game->numPlayers; i++) {
+            if (fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR) && 
+		    !fill_inbox(game, &game->processes[i])) {
+                return false;
             }
         }
     }
-    while (cards[0] && cards[1] && cards[2] && cards[3] && cards[4]) {
-        cards[0]--;
-        cards[1]--;
-        cards[2]--;
-        cards[3]--;
-        cards[4]--;
-        score += 10;
-    }
 
-    while (cards[0] && cards[1] && cards[2] && cards[3]) {
-        cards[0]--;
-        cards[1]--;
-        cards[2]--;
-        cards[3]--;
-        score += 7;
-    }
+    return true;
+}
 
-    while (cards[0] && cards[1] && cards[2]) {
-        cards[0]--;
-        cards[1]--;
-        cards[2]--;
-        score += 5;
-    }
+/*
+ * Receive a message from a player
+ * On success, return the site that the player has chosen to move to
+ * End the game early if the player does not reply in time, dies or makes an 
+ * invalid move
+ * */
+int receive_message(Game* game, int id) {
+    Frame frame;
 
-    while (cards[0] && cards[1]) {
-        cards[0]--;
-        cards[1]--;
-        score += 3;
+    if (!wait_for_message(game, id, &frame) || frame.type != DO || 
+	    frame.site <= game->players.position[id] || 
+	    frame.site >= game->pathSize || site_full(game, frame.site)) {
+        end_game_early(game);
     }
 
-    while (cards[0]) {
-        cards[0]--;
-        score += 1;
-    }
-    return score;
+    return frame.site;
 }
@@ -0,0 +1,93 @@
+#include "replay.h"
+
+void usage(void);
+void print_player(Game* game, int id);
+
+/*
+ * Replay a trace written by the dealer's -T option, checking every turn 
+ * against the rules of the game, and print the scores it ended with
+ * With -n the replay stops after that many turns and prints the state of 
+ * every player instead, and with -v every turn is printed as the dealer 
+ * printed it
+ * */
+int main(int argc, char** argv) {
+    int i, opt;
+    long long length, stop = EMPTY;
+    bool verbose = false;
+    char* end;
+
+    while ((opt = getopt(argc, argv, "n:v")) != -1) {
+        if (opt == 'n') {
+            stop = strtoll(optarg, &end, 10);
+            if (*end != '\0' || stop < 0) {
+                usage();
+            }
+        } else if (opt == 'v') {
+            verbose = true;
+        } else {
+            usage();
+        }
+    }
+    if (optind != argc - 1) {
+        usage();
+    }
+
+    TraceHeader* header = map_trace(argv[optind], &length);
+    TraceReplay replay;
+    if (!header || !initialise_replay(&replay, header, length)) {
+        fprintf(stderr, "Invalid trace\n");
+        exit(2);
+    }
+    if (stop == EMPTY) {
+        stop = replay.turns;
+    } else if (stop > replay.turns) {
+        fprintf(stderr, "Trace ends at turn %lld\n", replay.turns);
+        exit(3);
+    }
+
+    Game* game = &replay.game;
+    while (replay.turn < stop) {
+        long long turn = replay.turn + 1;
+        if (!replay_turn(&replay)) {
+            fprintf(stderr, "Trace does not match the game at turn %lld\n", 
+		    turn);
+            exit(4);
+        }
+        if (verbose) {
+            print_player(game, replay.records[replay.turn - 1].id);
+        }
+    }
+
+    if (game_over(game)) {
+        print_scores(game);
+    } else {
+        printf("Turn %lld of %lld\n", replay.turn, replay.turns);
+        for (i = 0; i < game->numPlayers; i++) {
+            print_player(game, i);
+        }
+    }
+    free_replay(&replay);
+
+    return 0;
+}
+
+/*
+ * Print the usage message and exit
+ * */
+void usage(void) {
+    fprintf(stderr, "Usage: 2310replay [-n turn] [-v] trace\n");
+    exit(1);
+}
+
+/*
+ * Print the state of a player in the same form as the dealer prints it 
+ * after each turn
+ * */
+void print_player(Game* game, int id) {
+    Players* players = &game->players;
+
+    printf("Player %d Money=%d V1=%d V2=%d Points=%d A=%d B=%d C=%d D=%d "
+	    "E=%d\n", id, players->money[id], players->v1[id], 
+	    players->v2[id], players->points[id], players->a[id], 
+	    players->b[id], players->c[id], players->d[id], players->e[id]);
+}
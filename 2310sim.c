@@ -0,0 +1,103 @@
+#include "engine.h"
+#include "common.h"
+#include <time.h>
+
+#define SIM_ARGS 4
+
+double elapsed(struct timespec* start, struct timespec* end);
+void print_results(Engine* engine, int* wins, long long* totals, int games,
+	double seconds);
+
+int main(int argc, char** argv) {
+    int i, g, games, numPlayers = argc - SIM_ARGS;
+    char* end;
+    bool verbose = false;
+
+    if (argc > 1 && !strcmp(argv[1], "-v")) {
+        verbose = true;
+        argv++;
+        argc--;
+        numPlayers--;
+    }
+    if (argc < SIM_ARGS + 1) {
+        fprintf(stderr, "Usage: 2310sim [-v] deck path games p1 {p2}\n");
+        exit(1);
+    }
+    games = strtol(argv[3], &end, 10);
+    if (*end != '\0' || games < 1) {
+        fprintf(stderr, "Usage: 2310sim [-v] deck path games p1 {p2}\n");
+        exit(1);
+    }
+
+    Strategy* seats = (Strategy*)malloc(sizeof(Strategy) * numPlayers);
+    for (i = 0; i < numPlayers; i++) {
+        seats[i] = find_strategy(argv[i + SIM_ARGS]);
+        if (!seats[i]) {
+            fprintf(stderr, "Unknown player type\n");
+            exit(4);
+        }
+    }
+
+    Engine engine;
+    initialise_engine(&engine, read_deckfile(argv[1]),
+	    read_pathfile(argv[2]), seats, numPlayers);
+
+    int* wins = (int*)calloc(numPlayers, sizeof(int));
+    long long* totals = (long long*)calloc(numPlayers, sizeof(long long));
+    struct timespec start, finish;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (g = 0; g < games; g++) {
+        run_game(&engine);
+        int best = 0;
+        for (i = 0; i < numPlayers; i++) {
+            totals[i] += engine.game.players.points[i];
+            if (engine.game.players.points[i] >
+		    engine.game.players.points[best]) {
+                best = i;
+            }
+        }
+        wins[best]++;
+        if (verbose) {
+            printf("Scores: ");
+            for (i = 0; i < numPlayers; i++) {
+                printf(i == numPlayers - 1 ? "%d\n" : "%d,",
+			engine.game.players.points[i]);
+            }
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+
+    print_results(&engine, wins, totals, games, elapsed(&start, &finish));
+    free_engine(&engine);
+
+    return 0;
+}
+
+/*
+ * Return the number of seconds between two points in time
+ * */
+double elapsed(struct timespec* start, struct timespec* end) {
+    return (end->tv_sec - start->tv_sec) +
+	    (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/*
+ * Print the wins and average score of each seat along with the throughput
+ * of the engine
+ * */
+void print_results(Engine* engine, int* wins, long long* totals, int games,
+	double seconds) {
+    int i, numPlayers = engine->game.numPlayers;
+
+    printf("Wins: ");
+    for (i = 0; i < numPlayers; i++) {
+        printf(i == numPlayers - 1 ? "%d\n" : "%d,", wins[i]);
+    }
+    printf("Average scores: ");
+    for (i = 0; i < numPlayers; i++) {
+        printf(i == numPlayers - 1 ? "%.2f\n" : "%.2f,",
+		(double)totals[i] / games);
+    }
+    printf("Games: %d in %.3fs (%.0f games/sec)\n", games, seconds,
+	    seconds > 0 ? games / seconds : 0.0);
+}
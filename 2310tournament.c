@@ -0,0 +1,198 @@
+#include "tournament.h"
+#include "common.h"
+#include <time.h>
+
+#define MAX_LINE 4096
+#define DEFAULT_CHUNK 256
+#define JOB_ARGS 4
+
+void usage(void);
+Job* read_jobs(char* fileName, int* numJobs);
+bool parse_job(Job* job, char* line);
+void print_results(Tournament* tournament, Result* totals, double seconds);
+
+int main(int argc, char** argv) {
+    int opt, numJobs, i, threads = sysconf(_SC_NPROCESSORS_ONLN);
+    int chunk = DEFAULT_CHUNK;
+    char* end;
+
+    while ((opt = getopt(argc, argv, "t:c:")) != -1) {
+        switch (opt) {
+            case 't':
+                threads = strtol(optarg, &end, 10);
+                if (*end != '\0' || threads < 1) {
+                    usage();
+                }
+                break;
+            case 'c':
+                chunk = strtol(optarg, &end, 10);
+                if (*end != '\0' || chunk < 1) {
+                    usage();
+                }
+                break;
+            default:
+                usage();
+        }
+    }
+    if (argc - optind != 1) {
+        usage();
+    }
+
+    Job* jobs = read_jobs(argv[optind], &numJobs);
+    Tournament tournament;
+    initialise_tournament(&tournament, jobs, numJobs, threads, chunk);
+
+    struct timespec start, finish;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    run_tournament(&tournament);
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+
+    Result* totals = (Result*)malloc(sizeof(Result) * numJobs);
+    for (i = 0; i < numJobs; i++) {
+        totals[i].games = 0;
+        totals[i].wins = (long long*)calloc(jobs[i].numPlayers,
+		sizeof(long long));
+        totals[i].points = (long long*)calloc(jobs[i].numPlayers,
+		sizeof(long long));
+    }
+    merge_results(&tournament, totals);
+    print_results(&tournament, totals, (finish.tv_sec - start.tv_sec) +
+	    (finish.tv_nsec - start.tv_nsec) / 1e9);
+
+    return 0;
+}
+
+/*
+ * Print the usage message and exit
+ * */
+void usage(void) {
+    fprintf(stderr, "Usage: 2310tournament [-t threads] [-c chunk] jobs\n");
+    exit(1);
+}
+
+/*
+ * Read the jobs file, one job per line in the form
+ * deck path games p1 {p2}
+ * Blank lines and lines starting with # are ignored
+ * Return the array of jobs or exit if a job is invalid
+ * */
+Job* read_jobs(char* fileName, int* numJobs) {
+    FILE* in = fopen(fileName, "r");
+    char line[MAX_LINE];
+    int capacity = 16, lineNumber = 0;
+
+    if (!in) {
+        fprintf(stderr, "Error reading jobs\n");
+        exit(2);
+    }
+
+    Job* jobs = (Job*)malloc(sizeof(Job) * capacity);
+    *numJobs = 0;
+    while (fgets(line, MAX_LINE, in)) {
+        lineNumber++;
+        line[strcspn(line, "\n")] = '\0';
+        if (line[strspn(line, " \t")] == '\0' || line[0] == '#') {
+            continue;
+        }
+        if (*numJobs == capacity) {
+            capacity *= 2;
+            jobs = (Job*)realloc(jobs, sizeof(Job) * capacity);
+        }
+        if (!parse_job(&jobs[*numJobs], line)) {
+            fprintf(stderr, "Error reading jobs (line %d)\n", lineNumber);
+            exit(2);
+        }
+        (*numJobs)++;
+    }
+    fclose(in);
+
+    if (*numJobs == 0) {
+        fprintf(stderr, "Error reading jobs\n");
+        exit(2);
+    }
+    return jobs;
+}
+
+/*
+ * Fill in a job from one line of the jobs file and load its deck and path
+ * Return true if the line is valid and false otherwise
+ * Exit if the deck or path cannot be used, as the dealer would
+ * */
+bool parse_job(Job* job, char* line) {
+    char* words[MAX_LINE / 2];
+    char* end;
+    int count = 0, i;
+    char* word = strtok(line, " \t");
+
+    while (word) {
+        words[count++] = strdup(word);
+        word = strtok(NULL, " \t");
+    }
+    if (count < JOB_ARGS) {
+        return false;
+    }
+
+    job->deckFile = words[0];
+    job->pathFile = words[1];
+    job->games = strtol(words[2], &end, 10);
+    if (*end != '\0' || job->games < 1) {
+        return false;
+    }
+    job->numPlayers = count - 3;
+    job->seats = (Strategy*)malloc(sizeof(Strategy) * job->numPlayers);
+    for (i = 0; i < job->numPlayers; i++) {
+        job->seats[i] = find_strategy(words[i + 3]);
+        if (!job->seats[i]) {
+            return false;
+        }
+    }
+    job->seatNames = (char**)malloc(sizeof(char*) * job->numPlayers);
+    memcpy(job->seatNames, words + 3, sizeof(char*) * job->numPlayers);
+
+    job->deckBuffer = read_deckfile(job->deckFile);
+    job->pathBuffer = read_pathfile(job->pathFile);
+
+    // Validate once here so that workers never have to
+    Engine engine;
+    initialise_engine(&engine, job->deckBuffer, job->pathBuffer, job->seats,
+	    job->numPlayers);
+    free_engine(&engine);
+
+    return true;
+}
+
+/*
+ * Print the totals for each job followed by the throughput of the whole
+ * tournament
+ * */
+void print_results(Tournament* tournament, Result* totals, double seconds) {
+    int i, j;
+    long long games = 0, stolen = 0;
+
+    for (j = 0; j < tournament->numJobs; j++) {
+        Job* job = &tournament->jobs[j];
+        printf("Job %d: %s %s", j + 1, job->deckFile, job->pathFile);
+        for (i = 0; i < job->numPlayers; i++) {
+            printf(" %s", job->seatNames[i]);
+        }
+        printf("\nWins: ");
+        for (i = 0; i < job->numPlayers; i++) {
+            printf(i == job->numPlayers - 1 ? "%lld\n" : "%lld,",
+		    totals[j].wins[i]);
+        }
+        printf("Average scores: ");
+        for (i = 0; i < job->numPlayers; i++) {
+            printf(i == job->numPlayers - 1 ? "%.2f\n" : "%.2f,",
+		    (double)totals[j].points[i] / totals[j].games);
+        }
+        games += totals[j].games;
+    }
+
+    for (i = 0; i < tournament->numWorkers; i++) {
+        stolen += tournament->workers[i].stolen;
+    }
+    printf("Games: %lld in %.3fs (%.0f games/sec) on %d threads, "
+	    "%lld tasks stolen\n", games, seconds,
+	    seconds > 0 ? games / seconds : 0.0, tournament->numWorkers,
+	    stolen);
+}
@@ -0,0 +1,97 @@
+#include "bench.h"
+#include <math.h>
+#include <time.h>
+
+/*
+ * Names picked on the command line, or NULL to run every benchmark
+ * */
+char** benchFilters = NULL;
+int benchFilterCount = 0;
+
+/*
+ * Where checksums go so that the operations are not optimised away
+ * */
+volatile long benchSink;
+
+/*
+ * Seed the random numbers used to build the inputs, so that every run 
+ * times the same work, and keep any names given as filters
+ * Print the heading of the results
+ * */
+void start_benchmarks(int argc, char** argv) {
+    srand(BENCH_SEED);
+    benchFilters = argv + 1;
+    benchFilterCount = argc - 1;
+    printf("%-36s %12s %9s %12s %12s\n", "benchmark", "ns/op", "stddev", 
+	    "min ns/op", "ops/sample");
+}
+
+/*
+ * Time an operation if its name contains one of the filters, or if there 
+ * are none
+ * It is run once to warm up and find how many iterations fill a sample of
+ * BENCH_SAMPLE_NS, then timed over BENCH_SAMPLES samples
+ * Print the mean time per operation, its standard deviation as a 
+ * percentage of the mean and the fastest sample
+ * */
+void run_benchmark(char* name, Operation operation, void* state) {
+    double samples[BENCH_SAMPLES], mean = 0, variance = 0, fastest;
+    int i, chosen = benchFilterCount == 0;
+
+    for (i = 0; i < benchFilterCount; i++) {
+        chosen |= strstr(name, benchFilters[i]) != NULL;
+    }
+    if (!chosen) {
+        return;
+    }
+
+    long iterations = calibrate(operation, state);
+    for (i = 0; i < BENCH_SAMPLES; i++) {
+        double start = now_ns();
+        benchSink += operation(state, iterations);
+        samples[i] = (now_ns() - start) / iterations;
+        mean += samples[i] / BENCH_SAMPLES;
+    }
+    fastest = samples[0];
+    for (i = 0; i < BENCH_SAMPLES; i++) {
+        variance += (samples[i] - mean) * (samples[i] - mean) / 
+		(BENCH_SAMPLES - 1);
+        fastest = samples[i] < fastest ? samples[i] : fastest;
+    }
+
+    printf("%-36s %12.2f %8.1f%% %12.2f %12ld\n", name, mean, 
+	    100 * sqrt(variance) / mean, fastest, iterations);
+    fflush(stdout);
+}
+
+/*
+ * Double the number of iterations until they take at least a tenth of a
+ * sample, then scale up to a whole sample
+ * Return the number of iterations to time in each sample
+ * */
+long calibrate(Operation operation, void* state) {
+    long iterations = 1;
+    double taken;
+
+    while (1) {
+        double start = now_ns();
+        benchSink += operation(state, iterations);
+        taken = now_ns() - start;
+        if (taken >= BENCH_SAMPLE_NS / 10) {
+            break;
+        }
+        iterations *= 2;
+    }
+
+    return (long)(iterations * BENCH_SAMPLE_NS / taken) + 1;
+}
+
+/*
+ * Return the time in nanoseconds from an arbitrary starting point
+ * */
+double now_ns(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
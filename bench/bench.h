@@ -0,0 +1,22 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "../common.h"
+
+#define BENCH_SEED 2310
+#define BENCH_SAMPLES 11
+#define BENCH_SAMPLE_NS 20000000.0
+
+/*
+ * An operation to time, carried out iterations times on state prepared 
+ * before timing starts
+ * Returns a checksum of the results so that the work cannot be left out
+ * */
+typedef long (*Operation)(void* state, long iterations);
+
+void start_benchmarks(int argc, char** argv);
+void run_benchmark(char* name, Operation operation, void* state);
+long calibrate(Operation operation, void* state);
+double now_ns(void);
+
+#endif
@@ -0,0 +1,213 @@
+#include "../protocol.h"
+#include <time.h>
+#include <sys/uio.h>
+
+#define DEFAULT_TURNS 20000
+#define MAX_PLAYERS 26
+
+double seconds_since(struct timespec* start);
+void start_players(int numPlayers, FILE** in, FILE** out);
+void run_player(FILE* in, FILE* out);
+void stop_players(int numPlayers, FILE** in, FILE** out);
+double eager_turns(int numPlayers, int turns);
+double coalesced_turns(int numPlayers, int turns);
+
+/*
+ * Compare the per-turn cost of sending every player each HAP as it happens
+ * against queueing HAPs and sending them with the next YT in one writev
+ * Each turn the current player is sent YT and replies with a DO
+ * Usage: broadcast [turns]
+ * */
+int main(int argc, char** argv) {
+    int turns = argc > 1 ? atoi(argv[1]) : DEFAULT_TURNS;
+    int sizes[] = {2, 4, 8, 10};
+    int i;
+
+    if (turns < 1) {
+        fprintf(stderr, "Usage: broadcast [turns]\n");
+        exit(1);
+    }
+
+    for (i = 0; i < sizeof(sizes) / sizeof(int); i++) {
+        double eager = eager_turns(sizes[i], turns);
+        double coalesced = coalesced_turns(sizes[i], turns);
+        printf("%2d players: eager %.2f us/turn (%d writes), coalesced "
+		"%.2f us/turn (1 write) %.1fx\n", sizes[i], 
+		eager * 1e6 / turns, sizes[i] + 1, coalesced * 1e6 / turns,
+		eager / coalesced);
+    }
+
+    return 0;
+}
+
+/*
+ * Return the number of seconds since start
+ * */
+double seconds_since(struct timespec* start) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + 
+	    (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/*
+ * Fork a child for each player connected by a pair of pipes
+ * */
+void start_players(int numPlayers, FILE** in, FILE** out) {
+    int i, j;
+
+    for (i = 0; i < numPlayers; i++) {
+        int toPlayer[2], fromPlayer[2];
+        if (pipe(toPlayer) || pipe(fromPlayer)) {
+            exit(5);
+        }
+        if (!fork()) {
+            for (j = 0; j < i; j++) {
+                fclose(in[j]);
+                fclose(out[j]);
+            }
+            close(toPlayer[STDOUT]);
+            close(fromPlayer[STDIN]);
+            run_player(fdopen(toPlayer[STDIN], "r"), 
+		    fdopen(fromPlayer[STDOUT], "w"));
+            _exit(0);
+        }
+        close(toPlayer[STDIN]);
+        close(fromPlayer[STDOUT]);
+        in[i] = fdopen(toPlayer[STDOUT], "w");
+        out[i] = fdopen(fromPlayer[STDIN], "r");
+    }
+}
+
+/*
+ * Read messages the way 2310A and 2310B do, answering each YT with a DO
+ * until DONE arrives
+ * */
+void run_player(FILE* in, FILE* out) {
+    char buffer[MAX_MSG_SIZE];
+    Frame frame;
+    int c, i;
+
+    do {
+        i = 0;
+        while (c = fgetc(in), c != '\n' && c != EOF) {
+            if (i < MAX_MSG_SIZE - 1) {
+                buffer[i++] = c;
+            }
+        }
+        buffer[i] = '\0';
+        if (!decode_line(buffer, &frame)) {
+            exit(6);
+        }
+        if (frame.type == YT) {
+            fprintf(out, "DO1\n");
+            fflush(out);
+        }
+    } while (frame.type != DONE);
+}
+
+/*
+ * Send DONE to every player and wait for them all to exit
+ * */
+void stop_players(int numPlayers, FILE** in, FILE** out) {
+    int i, status;
+
+    for (i = 0; i < numPlayers; i++) {
+        fprintf(in[i], "DONE\n");
+        fclose(in[i]);
+        fclose(out[i]);
+    }
+    for (i = 0; i < numPlayers; i++) {
+        wait(&status);
+    }
+}
+
+/*
+ * Play turns the way the dealer used to, with a separate formatted write 
+ * of each HAP to every player
+ * Return the time taken in seconds
+ * */
+double eager_turns(int numPlayers, int turns) {
+    FILE* in[MAX_PLAYERS];
+    FILE* out[MAX_PLAYERS];
+    char reply[MAX_MSG_SIZE];
+    int t, i;
+    struct timespec start;
+
+    start_players(numPlayers, in, out);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (t = 0; t < turns; t++) {
+        int id = t % numPlayers;
+        fprintf(in[id], "YT\n");
+        fflush(in[id]);
+        if (!fgets(reply, MAX_MSG_SIZE, out[id])) {
+            exit(5);
+        }
+        for (i = 0; i < numPlayers; i++) {
+            fprintf(in[i], "HAP%d,%d,%d,%d,%d\n", id, t % 100, t % 11, 
+		    t % 37, t % 6);
+            fflush(in[i]);
+        }
+    }
+    double seconds = seconds_since(&start);
+    stop_players(numPlayers, in, out);
+
+    return seconds;
+}
+
+/*
+ * Play turns the way the dealer does now, formatting each HAP once into a
+ * log and sending a player its unseen part of the log along with its YT
+ * Return the time taken in seconds
+ * */
+double coalesced_turns(int numPlayers, int turns) {
+    FILE* in[MAX_PLAYERS];
+    FILE* out[MAX_PLAYERS];
+    int delivered[MAX_PLAYERS] = {0};
+    char reply[MAX_MSG_SIZE];
+    char* log = (char*)malloc(MAX_MSG_SIZE * (numPlayers + 1));
+    int logSize = 0, t, i;
+    struct iovec parts[2];
+    struct timespec start;
+    Frame frame = {HAP, 0, 0, 0, 0, 0, 0};
+
+    start_players(numPlayers, in, out);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (t = 0; t < turns; t++) {
+        int id = t % numPlayers;
+        parts[0].iov_base = log + delivered[id];
+        parts[0].iov_len = logSize - delivered[id];
+        parts[1].iov_base = "YT\n";
+        parts[1].iov_len = 3;
+        if (writev(fileno(in[id]), parts, 2) < 0) {
+            exit(5);
+        }
+        delivered[id] = logSize;
+        if (!fgets(reply, MAX_MSG_SIZE, out[id])) {
+            exit(5);
+        }
+
+        // Drop whatever every player has seen, as trim_log does
+        int seen = logSize;
+        for (i = 0; i < numPlayers; i++) {
+            seen = delivered[i] < seen ? delivered[i] : seen;
+        }
+        memmove(log, log + seen, logSize - seen);
+        logSize -= seen;
+        for (i = 0; i < numPlayers; i++) {
+            delivered[i] -= seen;
+        }
+        frame.id = id;
+        frame.site = t % 100;
+        frame.points = t % 11;
+        frame.money = t % 37;
+        frame.card = t % 6;
+        logSize += encode_message(&frame, false, log + logSize);
+    }
+    double seconds = seconds_since(&start);
+    stop_players(numPlayers, in, out);
+    free(log);
+
+    return seconds;
+}
@@ -0,0 +1,258 @@
+#include "../common.h"
+#include <time.h>
+#include <errno.h>
+
+#define DEFAULT_GAMES 3
+#define DECK_SIZE 64
+#define BARRIER_SPACING 16
+#define SCORES "Scores: "
+#define CHUNK_SIZE 65536
+
+/*
+ * How long each part of a game took, in seconds, as seen from outside the
+ * dealer
+ * startup runs until the first board arrives, once every player has been 
+ * started and sent the path, turns until the scores arrive and shutdown 
+ * until the dealer has exited
+ * */
+typedef struct {
+    double startup;
+    double turns;
+    double shutdown;
+    long moves;
+} Timing;
+
+double seconds_since(struct timespec* start);
+void write_deck(char* fileName);
+void write_path(char* fileName, int pathSize, char* limit);
+bool play_one(char** dealerArgs, Timing* timing);
+void count_moves(char* text, int length, bool* lineStart, Timing* timing);
+bool run_workload(int numPlayers, int pathSize, char* limit, int games, 
+	char** options, int numOptions);
+
+/*
+ * Play whole games with 2310dealer, 2310A and 2310B over generated decks 
+ * and paths, sweeping the number of players, the length of the path and 
+ * the limit on sites other than barriers
+ * Report games per second and the time spent starting, playing and 
+ * shutting down
+ * Must be run from the directory holding the programs
+ * Usage: e2e [games [dealer options...]], e.g. e2e 3 -b -s
+ * */
+int main(int argc, char** argv) {
+    int playerCounts[] = {2, 8, 32, 128};
+    int pathSizes[] = {16, 128, 512};
+    char* limits[] = {"-", "1"};
+    int games = argc > 1 ? atoi(argv[1]) : DEFAULT_GAMES;
+    int p, s, l;
+
+    if (games < 1) {
+        fprintf(stderr, "Usage: e2e [games [dealer options...]]\n");
+        exit(1);
+    }
+    if (access("./2310dealer", X_OK) || access("./2310A", X_OK) || 
+	    access("./2310B", X_OK)) {
+        fprintf(stderr, "Run from the directory holding 2310dealer, "
+		"2310A and 2310B\n");
+        exit(1);
+    }
+
+    srand(2310);
+    printf("%7s %6s %5s %9s %11s %11s %11s %11s\n", "players", "sites", 
+	    "limit", "games/s", "startup ms", "turns ms", "shutdown ms", 
+	    "turns/s");
+    for (p = 0; p < sizeof(playerCounts) / sizeof(int); p++) {
+        for (s = 0; s < sizeof(pathSizes) / sizeof(int); s++) {
+            for (l = 0; l < sizeof(limits) / sizeof(char*); l++) {
+                if (!run_workload(playerCounts[p], pathSizes[s], limits[l], 
+			games, argv + 2, argc > 2 ? argc - 2 : 0)) {
+                    exit(2);
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * Return the number of seconds since start
+ * */
+double seconds_since(struct timespec* start) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + 
+	    (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/*
+ * Write a deck of DECK_SIZE random cards
+ * */
+void write_deck(char* fileName) {
+    FILE* out = fopen(fileName, "w");
+    int i;
+
+    fprintf(out, "%d", DECK_SIZE);
+    for (i = 0; i < DECK_SIZE; i++) {
+        fputc('A' + rand() % 5, out);
+    }
+    fprintf(out, "\n");
+    fclose(out);
+}
+
+/*
+ * Write a path of random sites with a barrier every BARRIER_SPACING sites 
+ * and the given limit on every other site
+ * */
+void write_path(char* fileName, int pathSize, char* limit) {
+    char* others[] = {"Mo", "V1", "V2", "Do", "Ri"};
+    FILE* out = fopen(fileName, "w");
+    int i;
+
+    fprintf(out, "%d;", pathSize);
+    for (i = 0; i < pathSize; i++) {
+        if (i % BARRIER_SPACING == 0 || i == pathSize - 1) {
+            fprintf(out, "::-");
+        } else {
+            fprintf(out, "%s%s", others[rand() % 5], limit);
+        }
+    }
+    fprintf(out, "\n");
+    fclose(out);
+}
+
+/*
+ * Play one game, reading the dealer's output as it arrives to see when the 
+ * first board and the scores are printed
+ * Return true and fill in timing if the game finished normally and false 
+ * otherwise
+ * */
+bool play_one(char** dealerArgs, Timing* timing) {
+    char buffer[CHUNK_SIZE + sizeof(SCORES)];
+    int fds[2], status, keep = 0;
+    ssize_t got;
+    bool started = false, scored = false, lineStart = true;
+    struct timespec mark;
+
+    if (pipe(fds) < 0) {
+        return false;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &mark);
+    pid_t pid = fork();
+    if (pid < 0) {
+        return false;
+    } else if (pid == 0) {
+        close(fds[STDIN]);
+        dup2(fds[STDOUT], STDOUT);
+        dup2(open("/dev/null", O_WRONLY), STDERR);
+        execv(dealerArgs[0], dealerArgs);
+        _exit(1);
+    }
+    close(fds[STDOUT]);
+
+    timing->moves = 0;
+    while ((got = read(fds[STDIN], buffer + keep, CHUNK_SIZE)) != 0) {
+        if (got < 0 && errno == EINTR) {
+            continue;
+        } else if (got < 0) {
+            break;
+        }
+        if (!started) {
+            timing->startup = seconds_since(&mark);
+            clock_gettime(CLOCK_MONOTONIC, &mark);
+            started = true;
+        }
+        count_moves(buffer + keep, got, &lineStart, timing);
+        buffer[keep + got] = '\0';
+        if (!scored && strstr(buffer, SCORES)) {
+            timing->turns = seconds_since(&mark);
+            clock_gettime(CLOCK_MONOTONIC, &mark);
+            scored = true;
+        }
+        // Keep the end in case the scores are split between two reads
+        int length = keep + got;
+        keep = length < strlen(SCORES) - 1 ? length : strlen(SCORES) - 1;
+        memmove(buffer, buffer + length - keep, keep);
+    }
+    close(fds[STDIN]);
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+    }
+    timing->shutdown = seconds_since(&mark);
+
+    return started && scored && WIFEXITED(status) && 
+	    WEXITSTATUS(status) == 0;
+}
+
+/*
+ * Count the lines of output that report a move, which are the only lines
+ * that start with 'P'
+ * lineStart carries whether the next byte starts a line from one read to 
+ * the next
+ * */
+void count_moves(char* text, int length, bool* lineStart, Timing* timing) {
+    int i;
+
+    for (i = 0; i < length; i++) {
+        if (*lineStart && text[i] == 'P') {
+            timing->moves++;
+        }
+        *lineStart = text[i] == '\n';
+    }
+}
+
+/*
+ * Write a deck and path for a workload, play it the given number of times
+ * with alternating type A and B players and print the mean timings
+ * Return false if a game failed
+ * */
+bool run_workload(int numPlayers, int pathSize, char* limit, int games, 
+	char** options, int numOptions) {
+    char deckName[] = "/tmp/e2e.deck.XXXXXX";
+    char pathName[] = "/tmp/e2e.path.XXXXXX";
+    int i, g, numArgs = 0;
+    Timing total = {0, 0, 0, 0}, timing;
+
+    close(mkstemp(deckName));
+    close(mkstemp(pathName));
+    write_deck(deckName);
+    write_path(pathName, pathSize, limit);
+
+    char** dealerArgs = (char**)malloc(sizeof(char*) * (numOptions + 
+	    numPlayers + 4));
+    dealerArgs[numArgs++] = "./2310dealer";
+    for (i = 0; i < numOptions; i++) {
+        dealerArgs[numArgs++] = options[i];
+    }
+    dealerArgs[numArgs++] = deckName;
+    dealerArgs[numArgs++] = pathName;
+    for (i = 0; i < numPlayers; i++) {
+        dealerArgs[numArgs++] = i % 2 ? "./2310B" : "./2310A";
+    }
+    dealerArgs[numArgs] = NULL;
+
+    bool ok = true;
+    for (g = 0; g < games && ok; g++) {
+        ok = play_one(dealerArgs, &timing);
+        total.startup += timing.startup;
+        total.turns += timing.turns;
+        total.shutdown += timing.shutdown;
+        total.moves += timing.moves;
+    }
+    unlink(deckName);
+    unlink(pathName);
+    free(dealerArgs);
+    if (!ok) {
+        fprintf(stderr, "Game with %d players on %d sites failed\n", 
+		numPlayers, pathSize);
+        return false;
+    }
+
+    double wall = total.startup + total.turns + total.shutdown;
+    printf("%7d %6d %5s %9.1f %11.2f %11.2f %11.2f %11.0f\n", numPlayers, 
+	    pathSize, limit, games / wall, total.startup * 1e3 / games, 
+	    total.turns * 1e3 / games, total.shutdown * 1e3 / games, 
+	    total.moves / total.turns);
+    fflush(stdout);
+    return true;
+}
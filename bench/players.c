@@ -0,0 +1,197 @@
+#include "../strategy.h"
+#include "../player.h"
+#include <time.h>
+
+#define SCANS (1 << 24)
+
+/*
+ * A player as it was laid out before the players were split into fields, 
+ * with the dealer's process state in among the counters
+ * */
+typedef struct {
+    int id;
+    int position;
+    pid_t pid;
+    int money;
+    int v1;
+    int v2;
+    int points;
+    int a;
+    int b;
+    int c;
+    int d;
+    int e;
+    FILE* in;
+    FILE* out;
+    char* inbox;
+    int received;
+    int delivered;
+} WholePlayer;
+
+long scan_whole(WholePlayer* players, int id, int pCount);
+long scan_fields(Players* players, int id, int pCount);
+bool whole_most_cards(WholePlayer* players, int id, int pCount);
+bool whole_no_cards(WholePlayer* players, int pCount);
+int whole_furthest_behind(WholePlayer* players, int pCount);
+int fields_furthest_behind(Players* players, int pCount);
+
+/*
+ * Compare the cost of the scans over every player that the strategies and 
+ * the end of the game make, when each player is one struct and when each 
+ * field of every player is its own array, for increasing numbers of players
+ * */
+int main(int argc, char** argv) {
+    int sizes[] = {16, 256, 4096, 65536, 1048576};
+    int s, i, k;
+    struct timespec start, end;
+
+    srand(2310);
+    printf("%8s %16s %16s %8s\n", "players", "struct ns/player", 
+	    "fields ns/player", "speedup");
+    for (s = 0; s < sizeof(sizes) / sizeof(int); s++) {
+        int pCount = sizes[s], repeat = SCANS / pCount;
+        WholePlayer* whole = (WholePlayer*)calloc(pCount, 
+		sizeof(WholePlayer));
+        Players fields;
+        create_players(&fields, pCount);
+        for (i = 0; i < pCount; i++) {
+            whole[i].position = fields.position[i] = 1 + rand() % 1000;
+            whole[i].a = fields.a[i] = rand() % 4;
+            whole[i].b = fields.b[i] = rand() % 4;
+            whole[i].c = fields.c[i] = rand() % 4;
+            whole[i].d = fields.d[i] = rand() % 4;
+            whole[i].e = fields.e[i] = rand() % 4;
+        }
+        // Give the last player the most cards so that every scan runs to 
+        // the end
+        whole[pCount - 1].a = fields.a[pCount - 1] = 100;
+
+        long wholeSum = 0, fieldsSum = 0;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        // Move a player before each scan, as a turn would
+        for (k = 0; k < repeat; k++) {
+            whole[k % pCount].position++;
+            wholeSum += scan_whole(whole, pCount - 1, pCount);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double wholeTime = (end.tv_sec - start.tv_sec) + 
+		(end.tv_nsec - start.tv_nsec) / 1e9;
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (k = 0; k < repeat; k++) {
+            fields.position[k % pCount]++;
+            fieldsSum += scan_fields(&fields, pCount - 1, pCount);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double fieldsTime = (end.tv_sec - start.tv_sec) + 
+		(end.tv_nsec - start.tv_nsec) / 1e9;
+
+        if (wholeSum != fieldsSum) {
+            fprintf(stderr, "Scans differ for %d players\n", pCount);
+            exit(1);
+        }
+        long scanned = (long)pCount * repeat;
+        printf("%8d %16.3f %16.3f %7.1fx\n", pCount, 
+		wholeTime * 1e9 / scanned, fieldsTime * 1e9 / scanned, 
+		wholeTime / fieldsTime);
+
+        free(whole);
+        free_players(&fields);
+    }
+
+    return 0;
+}
+
+/*
+ * Make the scans of a type B player and of the turn order over players 
+ * that are whole structs
+ * Return a checksum of what was found
+ * */
+long scan_whole(WholePlayer* players, int id, int pCount) {
+    return whole_most_cards(players, id, pCount) + 
+	    2 * whole_no_cards(players, pCount) + 
+	    4 * whole_furthest_behind(players, pCount);
+}
+
+/*
+ * Make the same scans over players split into fields
+ * Return a checksum of what was found
+ * */
+long scan_fields(Players* players, int id, int pCount) {
+    return most_cards(players, id, pCount) + 
+	    2 * no_cards(players, pCount) + 
+	    4 * fields_furthest_behind(players, pCount);
+}
+
+/*
+ * most_cards as it was written when each player was a struct
+ * */
+bool whole_most_cards(WholePlayer* players, int id, int pCount) {
+    int i, most = players[0].a + players[0].b + players[0].c + 
+	    players[0].d + players[0].e;
+
+    for (i = 0; i < pCount; i++) {
+        if (players[i].a + players[i].b + players[i].c + players[i].d + 
+	        players[i].e > most) {
+            most = players[i].a + players[i].b + players[i].c + players[i].d + 
+		    players[i].e;
+        }
+    }
+
+    if (players[id].a + players[id].b + players[id].c + players[id].d + 
+	    players[id].e >= most) {
+        for (i = 0; i < pCount; i++) {
+            if (players[i].a + players[i].b + players[i].c + players[i].d + 
+		    players[i].e >= most && i != id) {
+                return false;
+            }
+        }
+        return true;
+    } else {
+        return false;
+    }
+}
+
+/*
+ * no_cards as it was written when each player was a struct
+ * */
+bool whole_no_cards(WholePlayer* players, int pCount) {
+    int i;
+
+    for (i = 0; i < pCount; i++) {
+        if (players[i].a || players[i].b || players[i].c || players[i].d ||
+		players[i].e) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Find the lowest position of any player, as the dealer did before it kept
+ * track of the lowest occupied site, over players that are whole structs
+ * */
+int whole_furthest_behind(WholePlayer* players, int pCount) {
+    int i, lowest = players[0].position;
+
+    for (i = 1; i < pCount; i++) {
+        if (players[i].position < lowest) {
+            lowest = players[i].position;
+        }
+    }
+    return lowest;
+}
+
+/*
+ * Find the lowest position of any player over players split into fields
+ * */
+int fields_furthest_behind(Players* players, int pCount) {
+    int i, lowest = players->position[0];
+
+    for (i = 1; i < pCount; i++) {
+        if (players->position[i] < lowest) {
+            lowest = players->position[i];
+        }
+    }
+    return lowest;
+}
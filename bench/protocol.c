@@ -0,0 +1,164 @@
+#include "../protocol.h"
+#include <time.h>
+#include <sys/wait.h>
+
+#define DEFAULT_TURNS 1000000
+#define PLAYERS 4
+
+double seconds_since(struct timespec* start);
+double encode_decode(bool binary, int turns);
+void read_frames(FILE* in, bool binary);
+double turn_loop(bool binary, int turns);
+
+/*
+ * Compare the text and binary protocols, first formatting and parsing 
+ * messages in memory, then sending a game's worth of HAP and YT messages 
+ * over a pipe to a child that reads them the way a player does
+ * Usage: protocol [turns]
+ * */
+int main(int argc, char** argv) {
+    int turns = argc > 1 ? atoi(argv[1]) : DEFAULT_TURNS;
+    double text, binary;
+
+    if (turns < 1) {
+        fprintf(stderr, "Usage: protocol [turns]\n");
+        exit(1);
+    }
+
+    text = encode_decode(false, turns);
+    binary = encode_decode(true, turns);
+    printf("encode/decode: text %.1f ns/msg, binary %.1f ns/msg (%.1fx)\n",
+	    text * 1e9 / turns / PLAYERS, binary * 1e9 / turns / PLAYERS,
+	    text / binary);
+
+    text = turn_loop(false, turns);
+    binary = turn_loop(true, turns);
+    printf("turn loop: text %.0f turns/sec, binary %.0f turns/sec (%.1fx)\n",
+	    turns / text, turns / binary, text / binary);
+
+    return 0;
+}
+
+/*
+ * Return the number of seconds since start
+ * */
+double seconds_since(struct timespec* start) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + 
+	    (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/*
+ * Encode and decode one HAP per player for each turn
+ * Return the time taken in seconds
+ * */
+double encode_decode(bool binary, int turns) {
+    char buffer[MAX_MSG_SIZE];
+    Frame frame = {HAP, 0, 0, 0, 0, 0, 0}, decoded;
+    long long check = 0;
+    int t, i, length;
+    struct timespec start;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (t = 0; t < turns; t++) {
+        for (i = 0; i < PLAYERS; i++) {
+            frame.id = i;
+            frame.site = t % 100;
+            frame.money = t % 37;
+            frame.points = t % 11;
+            frame.card = t % 6;
+            length = encode_message(&frame, binary, buffer);
+            if (binary) {
+                memcpy(&decoded, buffer, sizeof(Frame));
+                valid_frame(&decoded);
+            } else {
+                buffer[length - 1] = '\0';
+                decode_line(buffer, &decoded);
+            }
+            check += decoded.site;
+        }
+    }
+    if (check < 0) {
+        printf("%lld\n", check);
+    }
+
+    return seconds_since(&start);
+}
+
+/*
+ * Read frames until DONE the way 2310A and 2310B do
+ * */
+void read_frames(FILE* in, bool binary) {
+    char buffer[MAX_MSG_SIZE];
+    Frame frame;
+    int c, i;
+
+    do {
+        if (binary) {
+            if (fread(&frame, sizeof(Frame), 1, in) != 1 || 
+		    !valid_frame(&frame)) {
+                exit(6);
+            }
+        } else {
+            i = 0;
+            while (c = fgetc(in), c != '\n' && c != EOF) {
+                if (i < MAX_MSG_SIZE - 1) {
+                    buffer[i++] = c;
+                }
+            }
+            buffer[i] = '\0';
+            if (!decode_line(buffer, &frame)) {
+                exit(6);
+            }
+        }
+    } while (frame.type != DONE);
+}
+
+/*
+ * Send a HAP for every player and a YT each turn to a child process, 
+ * flushing after each message as the dealer does
+ * Return the time taken in seconds
+ * */
+double turn_loop(bool binary, int turns) {
+    char buffer[MAX_MSG_SIZE];
+    Frame frame = {HAP, 0, 0, 0, 0, 0, 0};
+    Frame yt = {YT, 0, 0, 0, 0, 0, 0}, done = {DONE, 0, 0, 0, 0, 0, 0};
+    int fds[2], t, i, length, status;
+    struct timespec start;
+
+    if (pipe(fds)) {
+        exit(5);
+    }
+    if (!fork()) {
+        close(fds[1]);
+        read_frames(fdopen(fds[0], "r"), binary);
+        _exit(0);
+    }
+    close(fds[0]);
+    FILE* out = fdopen(fds[1], "w");
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (t = 0; t < turns; t++) {
+        length = encode_message(&yt, binary, buffer);
+        fwrite(buffer, sizeof(char), length, out);
+        fflush(out);
+        for (i = 0; i < PLAYERS; i++) {
+            frame.id = i;
+            frame.site = t % 100;
+            frame.money = t % 37;
+            frame.points = t % 11;
+            frame.card = t % 6;
+            length = encode_message(&frame, binary, buffer);
+            fwrite(buffer, sizeof(char), length, out);
+            fflush(out);
+        }
+    }
+    length = encode_message(&done, binary, buffer);
+    fwrite(buffer, sizeof(char), length, out);
+    fclose(out);
+    wait(&status);
+
+    return seconds_since(&start);
+}
@@ -0,0 +1,105 @@
+#include "../engine.h"
+#include <time.h>
+
+#define REPEAT 16
+#define DECK "7ABACDEE"
+#define PATH "12;::-Mo-V1-V2-Do-Ri-Mo-V1-Ri-V2-Do-::-"
+
+int scan_next_player(Game* game);
+double time_selection(Engine* engine, int (*select)(Game*), long* turns,
+	long* checksum);
+
+/*
+ * Compare the cost of choosing whose turn it is by scanning every player, 
+ * as the dealer used to, against the lowest occupied site cursor, for 
+ * games of increasing size
+ * */
+int main(int argc, char** argv) {
+    int sizes[] = {4, 16, 64, 256, 1024, 4096, 10000};
+    int s, i;
+
+    printf("%8s %8s %14s %14s %8s\n", "players", "turns", "scan ns/turn", 
+	    "cursor ns/turn", "speedup");
+    for (s = 0; s < sizeof(sizes) / sizeof(int); s++) {
+        int numPlayers = sizes[s];
+        Strategy* seats = (Strategy*)malloc(sizeof(Strategy) * numPlayers);
+        for (i = 0; i < numPlayers; i++) {
+            seats[i] = i % 2 ? strategy_b : strategy_a;
+        }
+        char* deck = strdup(DECK);
+        char* path = strdup(PATH);
+        Engine engine;
+        initialise_engine(&engine, deck, path, seats, numPlayers);
+
+        long turns, scanSum, cursorSum;
+        double scan = time_selection(&engine, scan_next_player, &turns, 
+		&scanSum);
+        double cursor = time_selection(&engine, next_player, &turns, 
+		&cursorSum);
+        if (scanSum != cursorSum) {
+            fprintf(stderr, "Turn order differs at %d players\n", 
+		    numPlayers);
+            exit(1);
+        }
+        printf("%8d %8ld %14.1f %14.1f %7.1fx\n", numPlayers, turns, 
+		scan * 1e9 / turns / REPEAT, cursor * 1e9 / turns / REPEAT,
+		scan / cursor);
+
+        free_engine(&engine);
+        free(seats);
+        free(deck);
+        free(path);
+    }
+
+    return 0;
+}
+
+/*
+ * The turn selection that the dealer used before it kept a cursor: find the
+ * lowest position across all players, then the last arrival at that site
+ * */
+int scan_next_player(Game* game) {
+    int i, last = game->players.position[0];
+
+    for (i = 1; i < game->numPlayers; i++) {
+        if (game->players.position[i] < last) {
+            last = game->players.position[i];
+        }
+    }
+
+    return game->sites[last].last;
+}
+
+/*
+ * Play one game, timing only the choice of whose turn it is
+ * Return the seconds spent choosing and set the number of turns and a 
+ * checksum of the turn order
+ * */
+double time_selection(Engine* engine, int (*select)(Game*), long* turns,
+	long* checksum) {
+    Game* game = &engine->game;
+    struct timespec start, end;
+    double seconds = 0;
+    int move[3], k, pID = 0;
+
+    reset_engine(engine);
+    *turns = 0;
+    *checksum = 0;
+    while (!game_over(game)) {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (k = 0; k < REPEAT; k++) {
+            pID = select(game);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        seconds += (end.tv_sec - start.tv_sec) + 
+		(end.tv_nsec - start.tv_nsec) / 1e9;
+
+        int site = engine->seats[pID](&engine->path, &game->players, pID,
+		game->numPlayers);
+        handle_move(game, site, pID, move);
+        *checksum = *checksum * 31 + pID;
+        (*turns)++;
+    }
+
+    return seconds;
+}
@@ -0,0 +1,135 @@
+#include "../score.h"
+#include "../player.h"
+#include <time.h>
+
+#define REPEAT 16
+#define MAX_CARDS 100
+
+int sorted_score(Players* players, int id);
+double time_players(int (*score)(Players*, int), Players* players, 
+	int count, long* checksum);
+double time_batch(Players* players, int* scores, int count, long* checksum);
+
+/*
+ * Compare the cost of scoring the cards of every player with the sort and 
+ * peel loops that each program used to have, with the closed form one 
+ * player at a time and with the closed form in batches, for increasing 
+ * numbers of players
+ * */
+int main(int argc, char** argv) {
+    int sizes[] = {1024, 16384, 262144, 1048576};
+    int s, i;
+
+    srand(2310);
+    printf("%8s %14s %14s %14s %8s\n", "players", "sorted ns/hand", 
+	    "closed ns/hand", "batch ns/hand", "speedup");
+    for (s = 0; s < sizeof(sizes) / sizeof(int); s++) {
+        int count = sizes[s];
+        Players players;
+        int* scores = (int*)malloc(sizeof(int) * count);
+        create_players(&players, count);
+        // Keep the counts small enough for the char counters of the old 
+        // scoring so that all three agree
+        for (i = 0; i < count; i++) {
+            players.a[i] = rand() % MAX_CARDS;
+            players.b[i] = rand() % MAX_CARDS;
+            players.c[i] = rand() % MAX_CARDS;
+            players.d[i] = rand() % MAX_CARDS;
+            players.e[i] = rand() % MAX_CARDS;
+        }
+
+        long sortedSum, closedSum, batchSum;
+        double sorted = time_players(sorted_score, &players, count, 
+		&sortedSum);
+        double closed = time_players(card_score, &players, count, 
+		&closedSum);
+        double batch = time_batch(&players, scores, count, &batchSum);
+        if (sortedSum != closedSum || batchSum != closedSum) {
+            fprintf(stderr, "Scores differ for %d players\n", count);
+            exit(1);
+        }
+        long hands = (long)count * REPEAT;
+        printf("%8d %14.2f %14.2f %14.2f %7.1fx\n", count, 
+		sorted * 1e9 / hands, closed * 1e9 / hands, batch * 1e9 / hands,
+		sorted / batch);
+
+        free_players(&players);
+        free(scores);
+    }
+
+    return 0;
+}
+
+/*
+ * card_score as it was before the closed form, with its peel loops folded
+ * into one
+ * */
+int sorted_score(Players* players, int id) {
+    int i, j, k, score = 0;
+    int points[] = {1, 3, 5, 7, 10};
+    char cards[5] = {players->a[id], players->b[id], players->c[id], 
+	    players->d[id], players->e[id]};
+
+    for (i = 0; i < 5; i++) {
+        for (j = i + 1; j < 5; j++) {
+            if (cards[j] > cards[i]) {
+                int tmp = cards[i];
+                cards[i] = cards[j];
+                cards[j] = tmp;
+            }
+        }
+    }
+    for (k = 4; k >= 0; k--) {
+        while (cards[k]) {
+            for (i = 0; i <= k; i++) {
+                cards[i]--;
+            }
+            score += points[k];
+        }
+    }
+
+    return score;
+}
+
+/*
+ * Score every player one at a time REPEAT times
+ * Return the seconds taken and set the sum of the scores
+ * */
+double time_players(int (*score)(Players*, int), Players* players, 
+	int count, long* checksum) {
+    struct timespec start, end;
+    int i, k;
+
+    *checksum = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (k = 0; k < REPEAT; k++) {
+        for (i = 0; i < count; i++) {
+            *checksum += score(players, i);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+/*
+ * Score every player in one batch REPEAT times
+ * Return the seconds taken and set the sum of the scores
+ * */
+double time_batch(Players* players, int* scores, int count, long* checksum) {
+    struct timespec start, end;
+    int i, k;
+
+    *checksum = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (k = 0; k < REPEAT; k++) {
+        card_scores(players->a, players->b, players->c, players->d, 
+		players->e, scores, count);
+        for (i = 0; i < count; i++) {
+            *checksum += scores[i];
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
@@ -0,0 +1,290 @@
+#include "../strategy.h"
+#include "../site.h"
+#include "../player.h"
+#include <time.h>
+
+#define REPEAT 64
+#define DO_SPACING 64
+#define BARRIER_SPACING 512
+
+typedef char Name[TYPE_SIZE + 1];
+
+char* make_path(int pathSize);
+int named_v_site(Path* path, Name* names, Players* players, int id);
+int named_do_site(Path* path, Name* names, Players* players, int id);
+int named_scan(Path* path, Name* names, Players* players, int id,
+	char* type);
+int scanned_v_site(Path* path, Players* players, int id);
+int scanned_do_site(Path* path, Players* players, int id);
+int scanned_scan(Path* path, Players* players, int id, int type);
+long evaluate_named(Path* path, Name* names, Players* players);
+long evaluate_scanned(Path* path, Name* names, Players* players);
+long evaluate_typed(Path* path, Name* names, Players* players);
+double time_evaluation(long (*evaluate)(Path*, Name*, Players*), Path* path,
+	Name* names, Players* players, long* checksum);
+
+/*
+ * Compare the cost of the searches along the path that the strategies make
+ * when site types are compared as strings, when the byte sized types are 
+ * scanned, as they used to be, and when the next site tables are used, for 
+ * paths of increasing length
+ * */
+int main(int argc, char** argv) {
+    int sizes[] = {64, 1024, 16384, 262144};
+    int s, i;
+
+    srand(2310);
+    printf("%8s %14s %14s %14s %8s\n", "sites", "names ns/move", 
+	    "scan ns/move", "table ns/move", "speedup");
+    for (s = 0; s < sizeof(sizes) / sizeof(int); s++) {
+        int pathSize = sizes[s];
+        char* text = make_path(pathSize);
+        Path path;
+        Players player;
+        create_players(&player, 1);
+        path.pathSize = pathSize;
+        path.sites = (Site*)malloc(sizeof(Site) * pathSize);
+        path.types = (unsigned char*)malloc(sizeof(unsigned char) * pathSize);
+        path.links = (Link*)malloc(sizeof(Link));
+        parse_sites(text, path.sites, path.types, pathSize, 1);
+        index_path(&path);
+
+        Name* names = (Name*)malloc(sizeof(Name) * pathSize);
+        for (i = 0; i < pathSize; i++) {
+            strcpy(names[i], siteNames[path.types[i]]);
+        }
+
+        long namedSum, scannedSum, typedSum;
+        double named = time_evaluation(evaluate_named, &path, names,
+		&player, &namedSum);
+        double scanned = time_evaluation(evaluate_scanned, &path, names,
+		&player, &scannedSum);
+        double typed = time_evaluation(evaluate_typed, &path, names,
+		&player, &typedSum);
+        if (namedSum != typedSum || scannedSum != typedSum) {
+            fprintf(stderr, "Moves differ on %d sites\n", pathSize);
+            exit(1);
+        }
+        long moves = (long)(pathSize - 1) * REPEAT;
+        printf("%8d %14.1f %14.1f %14.1f %7.1fx\n", pathSize,
+		named * 1e9 / moves, scanned * 1e9 / moves, typed * 1e9 / moves,
+		scanned / typed);
+
+        free(text);
+        free(names);
+        free(path.sites);
+        free(path.types);
+        free(path.next);
+        free(path.links);
+        free_players(&player);
+    }
+
+    return 0;
+}
+
+/*
+ * Build a path of random Mo, V1, V2 and Ri sites with a Do site every
+ * DO_SPACING sites and a barrier every BARRIER_SPACING sites
+ * Return the text of the sites
+ * */
+char* make_path(int pathSize) {
+    char* others[] = {"Mo", "V1", "V2", "Ri"};
+    char* text = (char*)malloc(sizeof(char) * (pathSize * SITE_SIZE + 1));
+    int i;
+
+    for (i = 0; i < pathSize; i++) {
+        char* type = others[rand() % 4];
+        if (i % BARRIER_SPACING == 0 || i == pathSize - 1) {
+            type = "::";
+        } else if (i % DO_SPACING == 0) {
+            type = "Do";
+        }
+        sprintf(text + i * SITE_SIZE, "%s-", type);
+    }
+
+    return text;
+}
+
+/*
+ * v_site as it was written when site types were strings
+ * */
+int named_v_site(Path* path, Name* names, Players* players, int id) {
+    int i;
+    for (i = players->position[id] + 1; i < path->pathSize; i++) {
+        if (!strcmp(names[i], "V1") || !strcmp(names[i], "V2") ||
+		!strcmp(names[i], "::")) {
+            if (!full_site(path, i)) {
+                return i;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * do_site as it was written when site types were strings
+ * */
+int named_do_site(Path* path, Name* names, Players* players, int id) {
+    int i;
+    for (i = players->position[id] + 1; i < path->pathSize; i++) {
+        if (!strcmp(names[i], "Do")) {
+            return i;
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * mo_site, v2_site and ri_site as they were written when site types were
+ * strings
+ * */
+int named_scan(Path* path, Name* names, Players* players, int id,
+	char* type) {
+    int i, count = 1;
+
+    for (i = players->position[id] + 1; i < path->pathSize; i++) {
+        if (!strcmp(names[i], "::")) {
+            return 0;
+        }
+
+        if (!strcmp(names[i], type) &&
+		!full_site(path, players->position[id] + count)) {
+            return players->position[id] + count;
+        }
+        count++;
+    }
+    return 0;
+}
+
+/*
+ * v_site as it was written before the next site tables
+ * */
+int scanned_v_site(Path* path, Players* players, int id) {
+    int i;
+    for (i = players->position[id] + 1; i < path->pathSize; i++) {
+        if (path->types[i] == SITE_V1 || path->types[i] == SITE_V2 || 
+		path->types[i] == SITE_BARRIER) {
+            if (!full_site(path, i)) {
+                return i;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * do_site as it was written before the next site tables
+ * */
+int scanned_do_site(Path* path, Players* players, int id) {
+    int i;
+    for (i = players->position[id] + 1; i < path->pathSize; i++) {
+        if (path->types[i] == SITE_DO) {
+            return i;
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * mo_site, v2_site and ri_site as they were written before the next site 
+ * tables
+ * */
+int scanned_scan(Path* path, Players* players, int id, int type) {
+    int i, count = 1;
+
+    for (i = players->position[id] + 1; i < path->pathSize; i++) {
+        if (path->types[i] == SITE_BARRIER) {
+            return 0;
+        }
+
+        if (path->types[i] == type && 
+		!full_site(path, players->position[id] + count)) {
+            return players->position[id] + count;
+        }
+        count++;
+    }
+    return 0;
+}
+
+/*
+ * Make every search that the strategies make from each site of the path
+ * using the names of the sites
+ * Return a checksum of the sites found
+ * */
+long evaluate_named(Path* path, Name* names, Players* players) {
+    long sum = 0;
+
+    for (players->position[0] = 0; players->position[0] < path->pathSize - 1;
+	    players->position[0]++) {
+        sum += named_v_site(path, names, players, 0);
+        sum += named_do_site(path, names, players, 0);
+        sum += named_scan(path, names, players, 0, "Mo");
+        sum += named_scan(path, names, players, 0, "V2");
+        sum += named_scan(path, names, players, 0, "Ri");
+    }
+
+    return sum;
+}
+
+/*
+ * Make every search that the strategies make from each site of the path
+ * by scanning the types of the sites, ignoring the names
+ * Return a checksum of the sites found
+ * */
+long evaluate_scanned(Path* path, Name* names, Players* players) {
+    long sum = 0;
+
+    for (players->position[0] = 0; players->position[0] < path->pathSize - 1;
+	    players->position[0]++) {
+        sum += scanned_v_site(path, players, 0);
+        sum += scanned_do_site(path, players, 0);
+        sum += scanned_scan(path, players, 0, SITE_MO);
+        sum += scanned_scan(path, players, 0, SITE_V2);
+        sum += scanned_scan(path, players, 0, SITE_RI);
+    }
+
+    return sum;
+}
+
+/*
+ * Make every search that the strategies make from each site of the path
+ * using the next site tables, ignoring the names
+ * Return a checksum of the sites found
+ * */
+long evaluate_typed(Path* path, Name* names, Players* players) {
+    long sum = 0;
+
+    for (players->position[0] = 0; players->position[0] < path->pathSize - 1;
+	    players->position[0]++) {
+        sum += v_site(path, players, 0);
+        sum += do_site(path, players, 0);
+        sum += mo_site(path, players, 0);
+        sum += v2_site(path, players, 0);
+        sum += ri_site(path, players, 0);
+    }
+
+    return sum;
+}
+
+/*
+ * Repeat the searches from every site REPEAT times
+ * Return the seconds taken and set the checksum of the sites found
+ * */
+double time_evaluation(long (*evaluate)(Path*, Name*, Players*), Path* path,
+	Name* names, Players* players, long* checksum) {
+    struct timespec start, end;
+    int k;
+
+    *checksum = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (k = 0; k < REPEAT; k++) {
+        *checksum += evaluate(path, names, players);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
@@ -0,0 +1,441 @@
+#include "bench.h"
+#include "../engine.h"
+#include "../site.h"
+#include "../score.h"
+#include "../player.h"
+#include "../protocol.h"
+#include "../replay.h"
+
+#define HANDS 1024
+#define MESSAGES 256
+#define PATH_SITES 1024
+#define GAME_SITES 64
+#define GAME_PLAYERS 8
+#define BARRIER_SPACING 16
+#define DECK "20ABCDEEDCBAACEBDDBECA"
+
+/*
+ * A game played once by the strategies, with every move kept so that it 
+ * can be replayed without deciding the moves again
+ * next is the move that the replay is up to
+ * */
+typedef struct {
+    Engine engine;
+    int* ids;
+    int* sites;
+    int moves;
+    int next;
+} Replay;
+
+/*
+ * HAP messages already formatted for the decoding benchmark, and the 
+ * frames they came from
+ * */
+typedef struct {
+    Frame frames[MESSAGES];
+    char lines[MESSAGES][MAX_MSG_SIZE];
+    char buffer[MAX_MSG_SIZE];
+} Messages;
+
+/*
+ * The text of a long path and the arrays it is parsed into
+ * */
+typedef struct {
+    char* text;
+    Path path;
+} PathText;
+
+char* make_path(int pathSize);
+void record_game(Replay* replay);
+void prepare_hands(Players* players);
+void prepare_messages(Messages* messages);
+void prepare_path(PathText* pathText);
+void prepare_trace(Replay* replay, TraceReplay* traceReplay);
+long op_card_score(void* state, long iterations);
+long op_card_scores(void* state, long iterations);
+long op_handle_move(void* state, long iterations);
+long op_turn(void* state, long iterations);
+long op_replay_turn(void* state, long iterations);
+long op_encode_text(void* state, long iterations);
+long op_encode_binary(void* state, long iterations);
+long op_decode_line(void* state, long iterations);
+long op_parse_path(void* state, long iterations);
+long op_strategy_a(void* state, long iterations);
+long op_strategy_b(void* state, long iterations);
+
+/*
+ * Time the hot paths of the game one at a time: scoring cards, moving 
+ * players, choosing whose turn it is, formatting and parsing messages, 
+ * parsing paths and deciding moves
+ * Usage: suite [name...] to run only the benchmarks whose names contain 
+ * one of the names given
+ * */
+int main(int argc, char** argv) {
+    Players hands;
+    Replay replay, midGame;
+    TraceReplay traceReplay;
+    Messages messages;
+    PathText pathText;
+
+    start_benchmarks(argc, argv);
+    prepare_hands(&hands);
+    record_game(&replay);
+    record_game(&midGame);
+    prepare_messages(&messages);
+    prepare_path(&pathText);
+    prepare_trace(&replay, &traceReplay);
+
+    // Leave the strategies halfway through the game
+    for (midGame.next = 0; midGame.next < midGame.moves / 2; 
+	    midGame.next++) {
+        int move[3];
+        handle_move(&midGame.engine.game, midGame.sites[midGame.next], 
+		midGame.ids[midGame.next], move);
+    }
+
+    run_benchmark("card_score", op_card_score, &hands);
+    run_benchmark("card_scores (per hand)", op_card_scores, &hands);
+    run_benchmark("handle_move", op_handle_move, &replay);
+    run_benchmark("turn (next_player + handle_move)", op_turn, &replay);
+    run_benchmark("replay_turn (trace record)", op_replay_turn, 
+	    &traceReplay);
+    run_benchmark("encode_message HAP text", op_encode_text, &messages);
+    run_benchmark("encode_message HAP binary", op_encode_binary, &messages);
+    run_benchmark("decode_line HAP", op_decode_line, &messages);
+    run_benchmark("parse_sites + index_path (1024)", op_parse_path, 
+	    &pathText);
+    run_benchmark("strategy_a", op_strategy_a, &midGame);
+    run_benchmark("strategy_b", op_strategy_b, &midGame);
+
+    return 0;
+}
+
+/*
+ * Build a path of random Mo, V1, V2, Do and Ri sites with a barrier every
+ * BARRIER_SPACING sites, a limit of 2 on every third site and '-' elsewhere
+ * Return the text of the path, including its size
+ * */
+char* make_path(int pathSize) {
+    char* others[] = {"Mo", "V1", "V2", "Do", "Ri"};
+    char* text = (char*)malloc(sizeof(char) * (pathSize * SITE_SIZE + 
+	    MAX_MSG_SIZE));
+    int i, length = sprintf(text, "%d;", pathSize);
+
+    for (i = 0; i < pathSize; i++) {
+        char* type = others[rand() % 5];
+        if (i % BARRIER_SPACING == 0 || i == pathSize - 1) {
+            length += sprintf(text + length, "::-");
+        } else {
+            length += sprintf(text + length, "%s%s", type, 
+		    i % 3 ? "-" : "2");
+        }
+    }
+
+    return text;
+}
+
+/*
+ * Set up a game between alternating type A and B strategies and record 
+ * each move they make until it is over
+ * */
+void record_game(Replay* replay) {
+    Strategy* seats = (Strategy*)malloc(sizeof(Strategy) * GAME_PLAYERS);
+    Game* game = &replay->engine.game;
+    int i, move[3], capacity = MAX_MSG_SIZE;
+
+    for (i = 0; i < GAME_PLAYERS; i++) {
+        seats[i] = i % 2 ? strategy_b : strategy_a;
+    }
+    initialise_engine(&replay->engine, strdup(DECK), make_path(GAME_SITES), 
+	    seats, GAME_PLAYERS);
+    reset_engine(&replay->engine);
+
+    replay->ids = (int*)malloc(sizeof(int) * capacity);
+    replay->sites = (int*)malloc(sizeof(int) * capacity);
+    replay->moves = 0;
+    while (!game_over(game)) {
+        int id = next_player(game);
+        int site = seats[id](&replay->engine.path, &game->players, id, 
+		GAME_PLAYERS);
+        if (replay->moves == capacity) {
+            capacity *= 2;
+            replay->ids = (int*)realloc(replay->ids, sizeof(int) * capacity);
+            replay->sites = (int*)realloc(replay->sites, sizeof(int) * 
+		    capacity);
+        }
+        replay->ids[replay->moves] = id;
+        replay->sites[replay->moves++] = site;
+        handle_move(game, site, id, move);
+    }
+
+    reset_engine(&replay->engine);
+    replay->next = 0;
+}
+
+/*
+ * Write the recorded game out as a trace, as the dealer's -T option would,
+ * and set up a replay of it
+ * */
+void prepare_trace(Replay* replay, TraceReplay* traceReplay) {
+    char fileName[] = "/tmp/suite-trace-XXXXXX";
+    char* seats[GAME_PLAYERS];
+    int i, move[3], fd = mkstemp(fileName);
+    long long length;
+
+    for (i = 0; i < GAME_PLAYERS; i++) {
+        seats[i] = i % 2 ? "2310B" : "2310A";
+    }
+    Trace* trace = fd < 0 ? NULL : open_trace(fileName, 
+	    &replay->engine.game, seats);
+    if (!trace) {
+        fprintf(stderr, "Error writing trace\n");
+        exit(1);
+    }
+    for (i = 0; i < replay->moves; i++) {
+        handle_move(&replay->engine.game, replay->sites[i], replay->ids[i], 
+		move);
+        trace_turn(trace, replay->ids[i], replay->sites[i], move);
+    }
+    reset_engine(&replay->engine);
+    TraceHeader* header = close_trace(trace) ? map_trace(fileName, &length) :
+	    NULL;
+    close(fd);
+    unlink(fileName);
+    if (!header || !initialise_replay(traceReplay, header, length) || 
+	    !seek_replay(traceReplay, traceReplay->turns)) {
+        fprintf(stderr, "Invalid trace\n");
+        exit(1);
+    }
+}
+
+/*
+ * Deal random hands of up to 15 of each card to HANDS players
+ * */
+void prepare_hands(Players* players) {
+    int i;
+
+    create_players(players, HANDS);
+    for (i = 0; i < HANDS; i++) {
+        players->a[i] = rand() % 16;
+        players->b[i] = rand() % 16;
+        players->c[i] = rand() % 16;
+        players->d[i] = rand() % 16;
+        players->e[i] = rand() % 16;
+    }
+}
+
+/*
+ * Make MESSAGES random HAP frames and their text, without the newline as 
+ * decode_line expects
+ * */
+void prepare_messages(Messages* messages) {
+    int i;
+
+    for (i = 0; i < MESSAGES; i++) {
+        Frame frame = {HAP, rand() % 6, 0, rand() % GAME_PLAYERS, 
+		rand() % 1000, rand() % 20, rand() % 40 - 20};
+        messages->frames[i] = frame;
+        int length = encode_message(&frame, false, messages->lines[i]);
+        messages->lines[i][length - 1] = '\0';
+    }
+}
+
+/*
+ * Make the text of a path of PATH_SITES sites and room to parse it into
+ * */
+void prepare_path(PathText* pathText) {
+    Path* path = &pathText->path;
+
+    pathText->text = make_path(PATH_SITES);
+    path->pathSize = PATH_SITES;
+    path->sites = (Site*)malloc(sizeof(Site) * PATH_SITES);
+    path->types = (unsigned char*)malloc(sizeof(unsigned char) * PATH_SITES);
+    path->next = NULL;
+}
+
+/*
+ * Score one hand at a time
+ * */
+long op_card_score(void* state, long iterations) {
+    Players* players = (Players*)state;
+    long i, sum = 0;
+
+    for (i = 0; i < iterations; i++) {
+        sum += card_score(players, i & (HANDS - 1));
+    }
+    return sum;
+}
+
+/*
+ * Score up to HANDS hands at a time in one batch, counting each hand as an 
+ * operation
+ * The last batch only scores the hands that are left, so that exactly 
+ * iterations hands are scored
+ * */
+long op_card_scores(void* state, long iterations) {
+    Players* players = (Players*)state;
+    int scores[HANDS];
+    long i, sum = 0;
+
+    for (i = 0; i < iterations; i += HANDS) {
+        int count = iterations - i < HANDS ? iterations - i : HANDS;
+        card_scores(players->a, players->b, players->c, players->d, 
+		players->e, scores, count);
+        sum += scores[(i / HANDS) % count];
+    }
+    return sum;
+}
+
+/*
+ * Make the recorded moves one after another, starting the game again once
+ * every move has been made
+ * The cost of starting again is shared out over the moves of the game
+ * */
+long op_handle_move(void* state, long iterations) {
+    Replay* replay = (Replay*)state;
+    Game* game = &replay->engine.game;
+    int move[3];
+    long i, sum = 0;
+
+    for (i = 0; i < iterations; i++) {
+        if (replay->next == replay->moves) {
+            reset_engine(&replay->engine);
+            replay->next = 0;
+        }
+        handle_move(game, replay->sites[replay->next], 
+		replay->ids[replay->next], move);
+        replay->next++;
+        sum += move[0];
+    }
+    return sum;
+}
+
+/*
+ * Choose whose turn it is as play_game does and make their recorded move
+ * */
+long op_turn(void* state, long iterations) {
+    Replay* replay = (Replay*)state;
+    Game* game = &replay->engine.game;
+    int move[3];
+    long i, sum = 0;
+
+    for (i = 0; i < iterations; i++) {
+        if (replay->next == replay->moves) {
+            reset_engine(&replay->engine);
+            replay->next = 0;
+        }
+        int id = next_player(game);
+        handle_move(game, replay->sites[replay->next], id, move);
+        replay->next++;
+        sum += id;
+    }
+    return sum;
+}
+
+/*
+ * Replay the turns of a trace one after another, checking each against the
+ * rules as 2310replay does, starting again once every turn has been made
+ * */
+long op_replay_turn(void* state, long iterations) {
+    TraceReplay* replay = (TraceReplay*)state;
+    long i, sum = 0;
+
+    for (i = 0; i < iterations; i++) {
+        if (replay->turn == replay->turns) {
+            reset_replay(replay);
+        }
+        sum += replay_turn(replay);
+    }
+    return sum;
+}
+
+/*
+ * Format one HAP as text
+ * */
+long op_encode_text(void* state, long iterations) {
+    Messages* messages = (Messages*)state;
+    long i, sum = 0;
+
+    for (i = 0; i < iterations; i++) {
+        sum += encode_message(&messages->frames[i & (MESSAGES - 1)], false,
+		messages->buffer);
+    }
+    return sum;
+}
+
+/*
+ * Format one HAP as a binary frame
+ * */
+long op_encode_binary(void* state, long iterations) {
+    Messages* messages = (Messages*)state;
+    long i, sum = 0;
+
+    for (i = 0; i < iterations; i++) {
+        sum += encode_message(&messages->frames[i & (MESSAGES - 1)], true,
+		messages->buffer);
+    }
+    return sum;
+}
+
+/*
+ * Parse one line of HAP text
+ * */
+long op_decode_line(void* state, long iterations) {
+    Messages* messages = (Messages*)state;
+    Frame frame;
+    long i, sum = 0;
+
+    for (i = 0; i < iterations; i++) {
+        decode_line(messages->lines[i & (MESSAGES - 1)], &frame);
+        sum += frame.site;
+    }
+    return sum;
+}
+
+/*
+ * Parse the sites of a long path and build its next site tables, as 
+ * create_sites and read_path do with each path
+ * */
+long op_parse_path(void* state, long iterations) {
+    PathText* pathText = (PathText*)state;
+    Path* path = &pathText->path;
+    char* sites = strchr(pathText->text, ';') + 1;
+    long i, sum = 0;
+
+    for (i = 0; i < iterations; i++) {
+        parse_sites(sites, path->sites, path->types, PATH_SITES, 
+		GAME_PLAYERS);
+        free(path->next);
+        index_path(path);
+        sum += path->next[0][SITE_DO];
+    }
+    return sum;
+}
+
+/*
+ * Decide a move for each type A seat in turn from the middle of a game
+ * */
+long op_strategy_a(void* state, long iterations) {
+    Replay* replay = (Replay*)state;
+    long i, sum = 0;
+
+    for (i = 0; i < iterations; i++) {
+        sum += strategy_a(&replay->engine.path, &replay->engine.game.players,
+		(i % (GAME_PLAYERS / 2)) * 2, GAME_PLAYERS);
+    }
+    return sum;
+}
+
+/*
+ * Decide a move for each type B seat in turn from the middle of a game
+ * */
+long op_strategy_b(void* state, long iterations) {
+    Replay* replay = (Replay*)state;
+    long i, sum = 0;
+
+    for (i = 0; i < iterations; i++) {
+        sum += strategy_b(&replay->engine.path, &replay->engine.game.players,
+		(i % (GAME_PLAYERS / 2)) * 2 + 1, GAME_PLAYERS);
+    }
+    return sum;
+}
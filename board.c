@@ -0,0 +1,210 @@
+#include "board.h"
+#include "site.h"
+
+/*
+ * Set up an empty board for a path, drawn to out
+ * Nothing is drawn if out is discarded, as drawing it would be wasted
+ * */
+void initialise_board(Board* board, unsigned char* types, int pathSize, 
+	int numPlayers, FILE* out) {
+    int i;
+
+    board->out = out;
+    board->render = !nobody_watching(out);
+    board->pathSize = pathSize;
+    board->numPlayers = numPlayers;
+    board->width = column_width(numPlayers);
+    board->lineSize = pathSize * board->width + 1;
+    board->rows = 0;
+    board->margin = EMPTY;
+    board->trailing = 0;
+    board->leading = 0;
+    board->window = NULL;
+    if (!board->render) {
+        return;
+    }
+
+    board->text = (char*)malloc(sizeof(char) * board->lineSize * 
+	    (numPlayers + 1));
+    board->rowSites = (int*)calloc(numPlayers + 1, sizeof(int));
+    memset(board->text, ' ', board->lineSize * (numPlayers + 1));
+    for (i = 0; i <= numPlayers; i++) {
+        board->text[board->lineSize * (i + 1) - 1] = '\n';
+    }
+    for (i = 0; i < pathSize; i++) {
+        memcpy(board->text + i * board->width, siteNames[types[i]], 
+		TYPE_SIZE);
+    }
+}
+
+/*
+ * Show only the part of the path around the players from now on, with 
+ * margin sites either side of them
+ * */
+void set_viewport(Board* board, int margin) {
+    board->margin = margin;
+    if (board->render) {
+        board->window = (char*)malloc(sizeof(char) * (board->lineSize * 
+		(board->numPlayers + 1) + MAX_MSG_SIZE));
+    }
+}
+
+/*
+ * Draw every player where they stand on an empty board
+ * */
+void place_players(Board* board, Site* sites, Link* links) {
+    int i;
+
+    board->trailing = EMPTY;
+    for (i = 0; board->render && i < board->pathSize; i++) {
+        draw_site(board, sites, links, i, 0);
+        if (sites[i].count && board->trailing == EMPTY) {
+            board->trailing = i;
+        }
+        if (sites[i].count) {
+            board->leading = i;
+        }
+    }
+}
+
+/*
+ * Redraw the players on one site in the order they arrived, clearing the 
+ * cells of the oldCount players who were drawn there before
+ * */
+void draw_site(Board* board, Site* sites, Link* links, int site, 
+	int oldCount) {
+    char* cell = board->text + board->lineSize + site * board->width;
+    int r, id, count = sites[site].count;
+
+    for (r = 0; r < oldCount; r++) {
+        memset(cell + r * board->lineSize, ' ', board->width);
+    }
+    for (r = 0, id = sites[site].first; id != EMPTY; 
+	    r++, id = links[id].next) {
+        write_id(cell + r * board->lineSize, id);
+    }
+
+    for (r = count; r < oldCount; r++) {
+        board->rowSites[r]--;
+    }
+    for (r = oldCount; r < count; r++) {
+        board->rowSites[r]++;
+    }
+    while (board->rows > 0 && !board->rowSites[board->rows - 1]) {
+        board->rows--;
+    }
+    if (count > board->rows) {
+        board->rows = count;
+    }
+}
+
+/*
+ * Update the board once a player has moved from one site to another
+ * Only the site they left needs redrawing, the player is simply added 
+ * below the others on the site they moved to
+ * */
+void move_on_board(Board* board, Site* sites, Link* links, int from, 
+	int to) {
+    int row = sites[to].count - 1;
+
+    if (!board->render) {
+        return;
+    }
+    draw_site(board, sites, links, from, sites[from].count + 1);
+    write_id(board->text + board->lineSize * (row + 1) + to * board->width,
+	    sites[to].last);
+    board->rowSites[row]++;
+    if (row >= board->rows) {
+        board->rows = row + 1;
+    }
+
+    if (to > board->leading) {
+        board->leading = to;
+    }
+    while (!sites[board->trailing].count) {
+        board->trailing++;
+    }
+}
+
+/*
+ * Print the names of the sites and every row that has a player on it 
+ * with a single write
+ * With a viewport, the part of the path shown is given first
+ * */
+void display_board(Board* board) {
+    int r, first, last, span, length;
+
+    if (!board->render) {
+        return;
+    }
+    if (board->margin == EMPTY) {
+        fwrite(board->text, sizeof(char), board->lineSize * 
+		(board->rows + 1), board->out);
+        return;
+    }
+
+    first = board->trailing > board->margin ? 
+	    board->trailing - board->margin : 0;
+    last = board->leading + board->margin < board->pathSize ? 
+	    board->leading + board->margin : board->pathSize - 1;
+    span = (last - first + 1) * board->width;
+    length = sprintf(board->window, "Sites %d-%d of %d\n", first, last, 
+	    board->pathSize);
+    for (r = 0; r <= board->rows; r++) {
+        memcpy(board->window + length, board->text + r * board->lineSize + 
+		first * board->width, span);
+        length += span;
+        board->window[length++] = '\n';
+    }
+    fwrite(board->window, sizeof(char), length, board->out);
+}
+
+/*
+ * Release everything allocated by initialise_board and set_viewport
+ * */
+void free_board(Board* board) {
+    if (board->render) {
+        free(board->text);
+        free(board->rowSites);
+        free(board->window);
+    }
+}
+
+/*
+ * Check whether a stream goes nowhere, because it is closed or writes to 
+ * /dev/null
+ * Return true if nothing written to it can be seen and false otherwise
+ * */
+bool nobody_watching(FILE* out) {
+    struct stat stream, null;
+
+    if (fstat(fileno(out), &stream) < 0) {
+        return true;
+    }
+    return stat("/dev/null", &null) == 0 && stream.st_dev == null.st_dev && 
+	    stream.st_ino == null.st_ino;
+}
+
+/*
+ * Return the width of a site on the board, wide enough for the largest ID
+ * and a space
+ * */
+int column_width(int numPlayers) {
+    int width = 2, largest = numPlayers - 1;
+
+    while (largest >= 10) {
+        largest /= 10;
+        width++;
+    }
+    return width < SITE_SIZE ? SITE_SIZE : width;
+}
+
+/*
+ * Write a player's ID into a board cell without terminating it
+ * */
+void write_id(char* cell, int id) {
+    char buffer[MAX_MSG_SIZE];
+    int length = sprintf(buffer, "%d", id);
+
+    memcpy(cell, buffer, length);
+}
@@ -0,0 +1,45 @@
+#ifndef BOARD_H
+#define BOARD_H
+
+#include "common.h"
+
+/*
+ * The picture of the path and the players on it
+ * text holds the names of the sites followed by one line per row of 
+ * players, so that a frame is written in one go
+ * rowSites counts the sites that have a player on each row, which gives 
+ * the number of rows to show without looking at the rows
+ * With a margin, only the sites from margin behind the trailing player to 
+ * margin ahead of the leading player are shown, copied into window first
+ * */
+typedef struct {
+    FILE* out;
+    bool render;
+    int pathSize;
+    int numPlayers;
+    int width;
+    int lineSize;
+    char* text;
+    int* rowSites;
+    int rows;
+    int margin;
+    int trailing;
+    int leading;
+    char* window;
+} Board;
+
+void initialise_board(Board* board, unsigned char* types, int pathSize, 
+	int numPlayers, FILE* out);
+void set_viewport(Board* board, int margin);
+void place_players(Board* board, Site* sites, Link* links);
+void draw_site(Board* board, Site* sites, Link* links, int site, 
+	int oldCount);
+void move_on_board(Board* board, Site* sites, Link* links, int from, 
+	int to);
+void display_board(Board* board);
+void free_board(Board* board);
+bool nobody_watching(FILE* out);
+int column_width(int numPlayers);
+void write_id(char* cell, int id);
+
+#endif
@@ -0,0 +1,439 @@
+#include "client.h"
+#include "site.h"
+#include "protocol.h"
+#include "shared.h"
+#include "compiled.h"
+#include "score.h"
+#include "player.h"
+#include <limits.h>
+
+/*
+ * Set once the dealer and this player have agreed to use the binary protocol
+ * */
+bool binaryProtocol = false;
+
+/*
+ * Set once the dealer and this player have agreed to play game after game,
+ * each started with NEWGAME
+ * */
+bool newGames = false;
+
+/*
+ * The game state published by the dealer, if this player agreed to use it
+ * */
+SharedState* sharedState = NULL;
+
+/*
+ * The compiled path offered by the dealer, if this player agreed to read it
+ * in place of the path on STDIN
+ * */
+CompiledHeader* compiledPath = NULL;
+
+/*
+ * Run a player that decides its moves with the given strategy, taking part 
+ * in games until the dealer is done with it
+ * Return the exit status of the player
+ * */
+int run_player(int argc, char** argv, Strategy strategy) {
+    check_arguments(argc, argv);
+    int pCount = atoi(argv[1]), id = atoi(argv[2]);
+    Path* path = (Path*)malloc(sizeof(Path));
+    Players players;
+    create_players(&players, pCount);
+
+    fprintf(stdout, "^");
+    fflush(stdout);
+
+    negotiate();
+    play_game(path, &players, id, pCount, strategy);
+    while (newGames && next_game(path, &players, pCount)) {
+        play_game(path, &players, id, pCount, strategy);
+    }
+
+    return 0;
+}
+
+/*
+ * Play one game on the path from the dealer, from reading the path to 
+ * printing the scores once the dealer sends DONE
+ * */
+void play_game(Path* path, Players* players, int id, int pCount, 
+	Strategy strategy) {
+    read_path(path, id, pCount);
+    Board board;
+    initialise_board(&board, path->types, path->pathSize, pCount, stderr);
+    place_players(&board, path->sites, path->links);
+    display_board(&board);
+    // Read positions and cards from the dealer's copy rather than replaying
+    Players shared;
+    Players* view = sharedState ? use_shared_state(path, &shared, pCount) : 
+	    players;
+
+    while (1) {
+        DealerMessage message = receive_message(&board, path, players, 
+		pCount);
+        if (message == YT) {
+            int site = play_move(path, view, id, pCount, strategy);
+            send_message(site);
+        } else if (message == HAP) {
+            display_board(&board);
+        } else if (message == EARLY) {
+            fprintf(stderr, "Early game over\n");
+            exit(5);
+        } else {
+            break;
+        }
+    }
+
+    if (sharedState) {
+        copy_players(players, view, pCount);
+    }
+    print_scores(players, pCount);
+    free_board(&board);
+}
+
+/*
+ * Wait to hear whether the dealer has another game once one is over
+ * On NEWGAME every player goes back to the start and the path is dropped, 
+ * then '^' tells the dealer that this player is ready for the next path
+ * Return true on NEWGAME or false once the dealer has closed STDIN, and 
+ * exit on any other message
+ * */
+bool next_game(Path* path, Players* players, int pCount) {
+    int i, c = fgetc(stdin);
+    Frame frame;
+
+    if (c == EOF) {
+        return false;
+    }
+    ungetc(c, stdin);
+    if (!read_frame(&frame) || frame.type != NEWGAME) {
+        fprintf(stderr, "Communications error\n");
+        exit(6);
+    }
+
+    for (i = 0; i < pCount; i++) {
+        reset_player(players, i);
+    }
+    if (!sharedState) {
+        free(path->sites);
+        free(path->links);
+    }
+    free(path->types);
+    free(path->next);
+    fputc('^', stdout);
+    fflush(stdout);
+
+    return true;
+}
+
+/*
+ * Ensure that the arguments provided are valid
+ * Exit if there aren't enough arguments or the player count or id is invalid
+ * */
+void check_arguments(int argc, char** argv) {
+    if (argc != 3) {
+        fprintf(stderr, "Usage: player pcount ID\n");
+        exit(1);
+    }
+
+    int pCount = atoi(argv[1]), id;
+    
+    if (pCount < 1) {
+        fprintf(stderr, "Invalid player count\n");
+        exit(2);
+    }
+
+    if (!strcmp(argv[2], "0")) {
+        id = 0;
+    } else {
+        id = atoi(argv[2]);
+        if (id <= 0 || id >= pCount) {
+            fprintf(stderr, "Invalid ID\n");
+            exit(3);
+        }
+    }
+}
+
+/*
+ * Read the path from STDIN, or from the compiled path the dealer offered,
+ * and create the sites that players can move to
+ * Exit if the path entered is invalid
+ * */
+void read_path(Path* path, int id, int pCount) {
+    int c, i = 0, size = MAX_MSG_SIZE;
+    char dummy;
+
+    if (compiledPath) {
+        path->pathSize = compiledPath->count;
+    } else if (fscanf(stdin, "%d%c", &(path->pathSize), &dummy) != 2 || 
+	    dummy != ';') {
+        path->pathSize = 0;
+    }
+    if (path->pathSize < 2) {
+        fprintf(stderr, "Invalid path\n");
+        exit(4);
+    }
+
+    char* buffer = (char*)malloc(sizeof(char) * size);
+    while (!compiledPath && (c = fgetc(stdin), c != '\n' && c != EOF)) {
+        if (i == size - 1) {
+            size *= 2;
+            buffer = (char*)realloc(buffer, sizeof(char) * size);
+        }
+        buffer[i] = c;
+        i++;
+    }
+    buffer[i] = '\0';
+
+    path->sites = (Site*)malloc(sizeof(Site) * path->pathSize);
+    path->types = (unsigned char*)malloc(sizeof(unsigned char) * 
+	    path->pathSize);
+    path->links = (Link*)malloc(sizeof(Link) * pCount);
+    if (!(compiledPath ? load_compiled_path(compiledPath, path->sites, 
+	    path->types, pCount) : parse_sites(buffer, path->sites, path->types,
+	    path->pathSize, pCount)) || !valid_path(path, pCount)) {
+        fprintf(stderr, "Invalid path\n");
+        exit(4);
+    }
+    index_path(path);
+    for (i = pCount - 1; i >= 0; i--) {
+        add_player(&path->sites[0], path->links, i);
+    }
+    free(buffer);
+}
+
+/*
+ * Check to see if the path entered is valid
+ * Return true if the path is valid or false if invalid
+ * */
+bool valid_path(Path* path, int pCount) {
+    int i, last = path->pathSize - 1;
+    for (i = 0; i < path->pathSize; i++) {
+        if (path->sites[i].limit < 0) {
+            return false;
+        }
+    }
+
+    if (path->types[0] != SITE_BARRIER || path->types[last] != SITE_BARRIER
+	    || path->sites[0].limit != pCount || 
+	    path->sites[last].limit != pCount) {
+        return false;
+    }
+
+    return true;
+}
+
+/*
+ * Send a message to STDOUT with the site that the player has chosen to move to
+ * */
+void send_message(int site) {
+    Frame frame = {DO, 0, 0, 0, site, 0, 0};
+    char buffer[MAX_MSG_SIZE];
+    int length = encode_message(&frame, binaryProtocol, buffer);
+
+    fwrite(buffer, sizeof(char), length, stdout);
+    fflush(stdout);
+}
+
+/*
+ * Accept the protocol extensions that the dealer offers before the path 
+ * Exit if the dealer offers something unknown or shared state that cannot 
+ * be mapped
+ * */
+void negotiate(void) {
+    int c, i = 0;
+    char offer[PATH_MAX + MAX_MSG_SIZE];
+
+    while ((c = fgetc(stdin)) == '^') {
+        offer[i++] = c;
+        while (c = fgetc(stdin), c != '\n' && c != EOF) {
+            if (i < sizeof(offer) - 2) {
+                offer[i++] = c;
+            }
+        }
+        offer[i++] = '\n';
+        offer[i] = '\0';
+        if (!strcmp(offer, BINARY_OFFER)) {
+            binaryProtocol = true;
+            fputc(BINARY_ACCEPT, stdout);
+        } else if (!strcmp(offer, NEWGAME_OFFER)) {
+            newGames = true;
+            fputc(NEWGAME_ACCEPT, stdout);
+        } else if (!strncmp(offer, SHARED_OFFER, strlen(SHARED_OFFER)) && 
+		(offer[i - 1] = '\0', sharedState = open_shared_state(offer + 
+		strlen(SHARED_OFFER)))) {
+            fputc(SHARED_ACCEPT, stdout);
+        } else if (!strncmp(offer, COMPILED_OFFER, strlen(COMPILED_OFFER)) &&
+		(offer[i - 1] = '\0', compiledPath = map_compiled(offer + 
+		strlen(COMPILED_OFFER), COMPILED_PATH))) {
+            fputc(COMPILED_ACCEPT, stdout);
+        } else {
+            fprintf(stderr, "Communications error\n");
+            exit(6);
+        }
+        fflush(stdout);
+        i = 0;
+    }
+    ungetc(c, stdin);
+}
+
+/*
+ * Point the sites of the path at the occupancy in the shared state, once the
+ * path has been read and the board set up
+ * Return view, pointed at the players in the shared state, or exit if the 
+ * state does not match the path
+ * */
+Players* use_shared_state(Path* path, Players* view, int pCount) {
+    int i;
+    Site* sites = shared_sites(sharedState);
+    char* end = (char*)sharedState + sharedState->size;
+
+    if (sharedState->numPlayers != pCount || 
+	    sharedState->pathSize != path->pathSize || 
+	    (char*)(shared_types(sharedState) + path->pathSize) > end) {
+        fprintf(stderr, "Communications error\n");
+        exit(6);
+    }
+    for (i = 0; i < path->pathSize; i++) {
+        if (sites[i].limit != path->sites[i].limit || 
+		shared_types(sharedState)[i] != path->types[i]) {
+            fprintf(stderr, "Communications error\n");
+            exit(6);
+        }
+    }
+    free(path->sites);
+    free(path->links);
+    path->sites = sites;
+    path->links = shared_links(sharedState);
+
+    attach_players(view, shared_players(sharedState), pCount);
+    return view;
+}
+
+/*
+ * Read the next message from the dealer in whichever protocol was agreed
+ * Return true if it is a valid message and false otherwise
+ * */
+bool read_frame(Frame* frame) {
+    int c, i = 0;
+    char buffer[MAX_MSG_SIZE];
+
+    if (binaryProtocol) {
+        return fread(frame, sizeof(Frame), 1, stdin) == 1 && 
+		valid_frame(frame);
+    }
+    while (c = fgetc(stdin), c != '\n' && c != EOF) {
+        if (i < MAX_MSG_SIZE - 1) {
+            buffer[i] = c;
+            i++;
+        }
+    }
+    buffer[i] = '\0';
+
+    return decode_line(buffer, frame);
+}
+
+/*
+ * Read a message from STDIN
+ * Return the message received on success or exit if there was a communications
+ * error
+ * */
+DealerMessage receive_message(Board* board, Path* path, Players* players, 
+	int pCount) {
+    Frame frame;
+    bool valid = read_frame(&frame);
+
+    if (!valid || frame.type == DO || frame.type == NEWGAME || 
+	    (frame.type == HAP && (sharedState || 
+	    (frame.card > 5 || frame.card < 0 || frame.site < 0 || 
+	    frame.site >= path->pathSize || frame.id < 0 || 
+	    frame.id >= pCount)))) {
+        fprintf(stderr, "Communications error\n");
+        exit(6);
+    }
+
+    if (frame.type == HAP) {
+        handle_move(board, path, players, frame.id, frame.site, 
+		frame.points, frame.money, frame.card);
+    }
+
+    return frame.type;
+}
+
+/*
+ * Carry out a move that has been given to the player
+ * Handles moves made via the HAP message
+ * */
+void handle_move(Board* board, Path* path, Players* players, int id, 
+	int site, int points, int money, int card) {
+    int currentSite = players->position[id];
+
+    players->points[id] += points;
+    players->money[id] += money;
+    if (path->types[site] == SITE_V1) {
+        players->v1[id]++;
+    }
+    if (path->types[site] == SITE_V2) {
+        players->v2[id]++;
+    }
+    if (card == 1) {
+        players->a[id]++;
+    } else if (card == 2) {
+        players->b[id]++;
+    } else if (card == 3) {
+        players->c[id]++;
+    } else if (card == 4) {
+        players->d[id]++;
+    } else if (card == 5) {
+        players->e[id]++;
+    } else {
+        //
+    }
+    remove_player(&path->sites[currentSite], path->links, id);
+    add_player(&path->sites[site], path->links, id);
+    players->position[id] = site;
+    move_on_board(board, path->sites, path->links, currentSite, site);
+    fprintf(stderr, 
+	    "Player %d Money=%d V1=%d V2=%d Points=%d A=%d B=%d C=%d "
+	    "D=%d E=%d\n", id, players->money[id], players->v1[id], 
+	    players->v2[id], players->points[id], players->a[id], 
+            players->b[id], players->c[id], players->d[id], players->e[id]);
+}
+
+/*
+ * Decide on a move with the strategy of this player
+ * Return the site that the player has chosen to move to
+ * */
+int play_move(Path* path, Players* players, int id, int pCount, 
+	Strategy strategy) {
+    unsigned version;
+    int nextSite;
+
+    // The move itself arrives back as a HAP or in the shared state
+    do {
+        version = begin_read(sharedState);
+        nextSite = strategy(path, players, id, pCount);
+    } while (!end_read(sharedState, version));
+
+    return nextSite;
+}
+
+/*
+ * Print the final scores of the players to STDERR at the completion
+ * of the game
+ * */
+void print_scores(Players* players, int pCount) {
+    int i;
+
+    fprintf(stderr, "Scores: ");
+    for (i = 0; i < pCount; i++) {
+        int cardScore = card_score(players, i);
+        players->points[i] += (players->v1[i] + players->v2[i] + cardScore);
+        if (i == pCount - 1) {
+            fprintf(stderr, "%d\n", players->points[i]);
+        } else {
+            fprintf(stderr, "%d,", players->points[i]);
+        }
+    }
+}
@@ -0,0 +1,27 @@
+#ifndef CLIENT_H
+#define CLIENT_H
+
+#include "common.h"
+#include "board.h"
+#include "strategy.h"
+
+int run_player(int argc, char** argv, Strategy strategy);
+void check_arguments(int argc, char** argv);
+void play_game(Path* path, Players* players, int id, int pCount, 
+	Strategy strategy);
+bool next_game(Path* path, Players* players, int pCount);
+void read_path(Path* path, int id, int pCount);
+bool valid_path(Path* path, int pCount);
+int play_move(Path* path, Players* players, int id, int pCount, 
+	Strategy strategy);
+void negotiate(void);
+Players* use_shared_state(Path* path, Players* view, int pCount);
+void send_message(int site);
+bool read_frame(Frame* frame);
+DealerMessage receive_message(Board* board, Path* path, Players* players, 
+	int pCount);
+void handle_move(Board* board, Path* path, Players* players, int id, 
+	int site, int points, int money, int card);
+void print_scores(Players* players, int pCount);
+
+#endif
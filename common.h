@@ -12,6 +12,7 @@
 #include <sys/wait.h>
 #include <sys/stat.h>
 #include <signal.h>
+#include <poll.h>
 
 #define SITE_SIZE 3
 #define TYPE_SIZE 2
@@ -19,45 +20,218 @@
 #define STDIN 0
 #define STDOUT 1
 #define STDERR 2
-#define MAX_MSG_SIZE 13
+#define MAX_MSG_SIZE 64
+#define EMPTY -1
 
+/*
+ * The kinds of site on the path, stored as one byte per site
+ * Site names are only looked at when the path is read or printed
+ * */
+typedef enum {
+    SITE_BARRIER,
+    SITE_MO,
+    SITE_V1,
+    SITE_V2,
+    SITE_DO,
+    SITE_RI,
+    SITE_TYPES
+} SiteType;
+
+/*
+ * A site on the path
+ * The players on it form a list in order of arrival, from first to last, 
+ * threaded through the links of the players
+ * */
 typedef struct {
-    char* type;
     int limit;
-    char* players;
+    int count;
+    int first;
+    int last;
 } Site;
 
+/*
+ * The players who arrived at the same site just before and after a player,
+ * or EMPTY
+ * */
+typedef struct {
+    int prev;
+    int next;
+} Link;
+
+#define PLAYER_FIELDS 10
+
+/*
+ * The state of every player that changes as the game is played, with one 
+ * array per field indexed by player ID
+ * A scan over one field of every player, such as looking for the most 
+ * cards, reads consecutive ints rather than striding over whole players
+ * The arrays are cut from one block of PLAYER_FIELDS ints per player
+ * */
+typedef struct {
+    int* position;
+    int* money;
+    int* v1;
+    int* v2;
+    int* points;
+    int* a;
+    int* b;
+    int* c;
+    int* d;
+    int* e;
+} Players;
+
+/*
+ * A player process that the dealer talks to, and the messages it has sent 
+ * that are yet to be read
+ * */
 typedef struct {
-    char id;
-    int position;
     pid_t pid;
-    int money;
-    int v1;
-    int v2;
-    int points;
-    int a;
-    int b;
-    int c;
-    int d;
-    int e;
     FILE* in;
     FILE* out;
-} Player;
+    char* inbox;
+    int received;
+    int delivered;
+} Process;
 
+/*
+ * Represents the path made up of sites
+ * The type of each site is kept apart from its occupancy so that searching 
+ * along the path for a type reads one byte per site
+ * next holds, for each site, the position of the next site of each type 
+ * after it, or pathSize if there is none
+ * lowest is no further along than the site furthest back with a player on 
+ * it, and only ever moves forward during a game
+ * */
 typedef struct {
+    int pathSize;
+    unsigned char* types;
+    int (*next)[SITE_TYPES];
     Site* sites;
-    Player* players;
+    Link* links;
+    int lowest;
+} Path;
+
+/*
+ * Header of the game state that the dealer publishes in shared memory
+ * It is followed by the fields of every player, every site, the links 
+ * between players and then the type of every site
+ * seq is odd while the dealer is part way through a change
+ * */
+typedef struct {
+    unsigned seq;
+    int numPlayers;
+    int pathSize;
+    int size;
+} SharedState;
+
+#define STATS_SUB_BITS 3
+#define STATS_SUB_BUCKETS (1 << STATS_SUB_BITS)
+#define STATS_BUCKETS (64 << STATS_SUB_BITS)
+
+/*
+ * How long one player has taken to answer each YT, in nanoseconds
+ * Each power of two is split into STATS_SUB_BUCKETS buckets, so a 
+ * percentile read from the buckets is within an eighth of the true value
+ * */
+typedef struct {
+    long long turns;
+    long long total;
+    long long max;
+    unsigned buckets[STATS_BUCKETS];
+} Latency;
+
+/*
+ * The parts of a game that the dealer's profiler times
+ * */
+typedef enum {
+    PHASE_READ,
+    PHASE_SITES,
+    PHASE_PLAYERS,
+    PHASE_PATH,
+    PHASE_TURNS,
+    PHASE_RENDER,
+    PHASE_SCORES,
+    PHASE_SHUTDOWN,
+    PHASES
+} Phase;
+
+/*
+ * The wall clock and CPU time spent in each phase so far, in nanoseconds, 
+ * and when the phases being timed were entered
+ * */
+typedef struct {
+    long long calls[PHASES];
+    long long wall[PHASES];
+    long long cpu[PHASES];
+    long long wallStart[PHASES];
+    long long cpuStart[PHASES];
+} Profile;
+
+#define TRACE_BUFFER_SIZE 65536
+
+/*
+ * A binary trace of a game being written, with the bytes not yet written 
+ * held in buffer
+ * failed is set by the first write that does not succeed, after which 
+ * nothing more is written
+ * */
+typedef struct {
+    int fd;
+    char* buffer;
+    int used;
+    bool failed;
+} Trace;
+
+typedef struct {
+    Site* sites;
+    unsigned char* types;
+    Players players;
+    Process* processes;
     char* deck;
+    int deckSize;
+    int drawn;
     int numPlayers;
     int pathSize;
+    int lowest;
+    Link* links;
     bool sighup;
+    int timeout;
+    bool binary;
+    int childPipe[2];
+    struct pollfd* pollFds;
+    char* log;
+    int logSize;
+    int logCapacity;
+    SharedState* shared;
+    char* sharedName;
+    char* compiledName;
+    Latency* latencies;
+    char* statsName;
+    Profile* profile;
+    Trace* trace;
+    bool newGames;
 } Game;
 
 typedef enum {
     YT,
     EARLY,
     DONE,
-    HAP
+    HAP,
+    DO,
+    NEWGAME
 } DealerMessage;
 
+/*
+ * A message in the binary protocol, every message is the same size
+ * */
+typedef struct {
+    unsigned char type;
+    signed char card;
+    unsigned short reserved;
+    int id;
+    int site;
+    int points;
+    int money;
+} Frame;
+
 #endif
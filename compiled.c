@@ -0,0 +1,222 @@
+#include "compiled.h"
+#include "site.h"
+#include <sys/mman.h>
+
+/*
+ * Map a file into memory read only rather than copying it, followed by at 
+ * least one null byte so that it can be used as a string
+ * The file stays mapped until it is given to unmap_file or the program 
+ * exits
+ * Return the contents of the file and set its length, or return NULL if it 
+ * could not be mapped
+ * */
+char* map_file(char* fileName, long long* length) {
+    struct stat info;
+    int fd = open(fileName, O_RDONLY);
+
+    if (fd < 0) {
+        return NULL;
+    }
+    if (fstat(fd, &info) < 0 || !S_ISREG(info.st_mode)) {
+        close(fd);
+        return NULL;
+    }
+
+    // Reserve a zeroed page past the end of the file, then map the file 
+    // over the start of it
+    char* buffer = (char*)mmap(NULL, mapped_size(info.st_size), PROT_READ, 
+	    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buffer == MAP_FAILED) {
+        close(fd);
+        return NULL;
+    }
+    if (info.st_size > 0 && mmap(buffer, info.st_size, PROT_READ, 
+	    MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        unmap_file(buffer, info.st_size);
+        close(fd);
+        return NULL;
+    }
+    close(fd);
+
+    if (length) {
+        *length = info.st_size;
+    }
+    return buffer;
+}
+
+/*
+ * Return the number of bytes that map_file maps for a file of the given 
+ * length, which is rounded up to whole pages with at least one byte spare
+ * */
+long long mapped_size(long long length) {
+    long page = sysconf(_SC_PAGESIZE);
+
+    return length / page * page + page;
+}
+
+/*
+ * Release a file mapped by map_file, given the length it was mapped with
+ * */
+void unmap_file(char* buffer, long long length) {
+    munmap(buffer, mapped_size(length));
+}
+
+/*
+ * Return the FNV-1a hash of some data
+ * */
+unsigned checksum(char* data, long long length) {
+    unsigned hash = 2166136261u;
+    long long i;
+
+    for (i = 0; i < length; i++) {
+        hash = (hash ^ (unsigned char)data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+/*
+ * Return the name of the compiled file for a deck or path file
+ * */
+char* compiled_name(char* fileName) {
+    char* name = (char*)malloc(sizeof(char) * (strlen(fileName) + 
+	    strlen(COMPILED_SUFFIX) + 1));
+
+    sprintf(name, "%s%s", fileName, COMPILED_SUFFIX);
+    return name;
+}
+
+/*
+ * Check whether a mapped file is a compiled deck or path, rather than text 
+ * Return true if it is compiled and of the given kind and false otherwise
+ * */
+bool is_compiled(char* buffer, int kind) {
+    return !strncmp(buffer, COMPILED_MAGIC, strlen(COMPILED_MAGIC)) && 
+	    ((CompiledHeader*)buffer)->kind == kind;
+}
+
+/*
+ * Map a compiled file and make sure that it is complete
+ * Return the header of the file or NULL if it is not a compiled file of 
+ * the given kind
+ * */
+CompiledHeader* map_compiled(char* fileName, int kind) {
+    long long length;
+    char* buffer = map_file(fileName, &length);
+    CompiledHeader* header = (CompiledHeader*)buffer;
+
+    if (!buffer) {
+        return NULL;
+    }
+    if (length < sizeof(CompiledHeader) || !is_compiled(buffer, kind) || 
+	    header->version != COMPILED_VERSION || header->count < 1 || 
+	    compiled_size(header) != length) {
+        unmap_file(buffer, length);
+        return NULL;
+    }
+
+    return header;
+}
+
+/*
+ * Return the length of a compiled file from its header
+ * */
+long long compiled_size(CompiledHeader* header) {
+    if (header->kind == COMPILED_DECK) {
+        return sizeof(CompiledHeader) + header->count;
+    }
+    return (char*)(compiled_limits(header) + header->count) - (char*)header;
+}
+
+/*
+ * Release a compiled file mapped by map_compiled
+ * */
+void unmap_compiled(CompiledHeader* header) {
+    unmap_file((char*)header, compiled_size(header));
+}
+
+/*
+ * Map the compiled form of a deck or path file if it is up to date with 
+ * the text
+ * It is up to date if the size and modification time of the text are the 
+ * ones it was compiled from, or if the text has been touched or copied 
+ * without changing what it says
+ * Return the header of the compiled file or NULL if there is none that can 
+ * be used
+ * */
+CompiledHeader* map_fresh_compiled(char* fileName, int kind) {
+    struct stat info;
+    char* name = compiled_name(fileName);
+    CompiledHeader* header = map_compiled(name, kind);
+    long long length;
+
+    free(name);
+    if (!header) {
+        return NULL;
+    }
+    if (stat(fileName, &info) < 0 || header->sourceSize != info.st_size) {
+        unmap_compiled(header);
+        return NULL;
+    }
+    if (header->sourceSeconds == info.st_mtim.tv_sec && 
+	    header->sourceNanoseconds == info.st_mtim.tv_nsec) {
+        return header;
+    }
+
+    char* text = map_file(fileName, &length);
+    bool same = text && checksum(text, length) == header->checksum;
+    if (text) {
+        unmap_file(text, length);
+    }
+    if (!same) {
+        unmap_compiled(header);
+        return NULL;
+    }
+    return header;
+}
+
+/*
+ * Return the cards of a compiled deck
+ * */
+char* compiled_cards(CompiledHeader* header) {
+    return (char*)(header + 1);
+}
+
+/*
+ * Return the types of the sites of a compiled path
+ * */
+unsigned char* compiled_types(CompiledHeader* header) {
+    return (unsigned char*)(header + 1);
+}
+
+/*
+ * Return the limits of the sites of a compiled path, which follow the 
+ * types and start on a multiple of the size of an int
+ * */
+int* compiled_limits(CompiledHeader* header) {
+    int offset = (header->count + sizeof(int) - 1) / sizeof(int);
+
+    return (int*)(header + 1) + offset;
+}
+
+/*
+ * Fill in the sites and their types from a compiled path for a game with 
+ * the given number of players
+ * Return true if every site has a known type and false otherwise
+ * */
+bool load_compiled_path(CompiledHeader* header, Site* sites, 
+	unsigned char* types, int numPlayers) {
+    unsigned char* compiledTypes = compiled_types(header);
+    int* limits = compiled_limits(header);
+    int i;
+
+    for (i = 0; i < header->count; i++) {
+        if (compiledTypes[i] >= SITE_TYPES || limits[i] < 0) {
+            return false;
+        }
+        types[i] = compiledTypes[i];
+        sites[i].limit = limits[i] > numPlayers ? numPlayers : limits[i];
+        clear_site(&sites[i]);
+    }
+
+    return true;
+}
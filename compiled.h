@@ -0,0 +1,53 @@
+#ifndef COMPILED_H
+#define COMPILED_H
+
+#include "common.h"
+
+#define COMPILED_MAGIC "\x7f" "231"
+#define COMPILED_VERSION 1
+#define COMPILED_SUFFIX ".bin"
+#define COMPILED_OFFER "^C"
+#define COMPILED_ACCEPT 'C'
+#define EVERY_PLAYER 0x7fffffff
+
+typedef enum {
+    COMPILED_DECK,
+    COMPILED_PATH
+} CompiledKind;
+
+/*
+ * Header of a deck or path that has already been validated and compiled 
+ * from its text file
+ * A deck is followed by its cards, a path by the type of every site and 
+ * then the limit of every site, with EVERY_PLAYER standing for '-'
+ * The size, modification time and checksum of the text file tie the 
+ * compiled file to the version of the text it was compiled from
+ * */
+typedef struct {
+    char magic[4];
+    unsigned short version;
+    unsigned short kind;
+    int count;
+    unsigned checksum;
+    long long sourceSize;
+    long long sourceSeconds;
+    long long sourceNanoseconds;
+} CompiledHeader;
+
+char* map_file(char* fileName, long long* length);
+long long mapped_size(long long length);
+void unmap_file(char* buffer, long long length);
+unsigned checksum(char* data, long long length);
+char* compiled_name(char* fileName);
+bool is_compiled(char* buffer, int kind);
+CompiledHeader* map_compiled(char* fileName, int kind);
+long long compiled_size(CompiledHeader* header);
+void unmap_compiled(CompiledHeader* header);
+CompiledHeader* map_fresh_compiled(char* fileName, int kind);
+char* compiled_cards(CompiledHeader* header);
+unsigned char* compiled_types(CompiledHeader* header);
+int* compiled_limits(CompiledHeader* header);
+bool load_compiled_path(CompiledHeader* header, Site* sites, 
+	unsigned char* types, int numPlayers);
+
+#endif
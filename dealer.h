@@ -2,30 +2,44 @@
 #define DEALER_H
 
 #include "common.h"
+#include "game.h"
+#include "board.h"
+#include <sys/uio.h>
 
 void sighup_handler(int signalNumber);
+void sigchld_handler(int signalNumber);
+void install_handlers(Game* game);
+void raise_file_limit(Game* game);
 void shut_down_players(Game* game);
-char* read_deckfile(char* fileName);
-char* read_pathfile(char* fileName);
-char* check_deckfile(char* buffer);
-Site* create_sites(Game* game, char* buffer, int argc);
+void end_game_early(Game* game);
 void create_pipes(Game* game);
-bool valid_path(Game* game, Site* sites, int pathSize, int argc);
 void initialise_players(Game* game, char** argv, char* path);
-void initialise_game(Game* game, char* deck, Site* sites, int argc);
-void play_game(char** board, Game* game);
-void send_message(DealerMessage message, FILE* stream, int id, 
+bool read_byte(Game* game, int id, char* c);
+bool receive_handshake(Game* game, int id);
+bool negotiate(Game* game, int id);
+void share_state(Game* game);
+void remove_shared_name(Game* game);
+void unshare_players(Game* game);
+void make_move(Game* game, int id, int site, int* move);
+void new_game(Game* game);
+void play_game(Board* board, Game* game);
+void save_stats(Game* game);
+void save_trace(Game* game);
+void send_message(Game* game, DealerMessage message, FILE* stream, int id, 
 	int site, int points, int money, int card);
 void send_path(Game* game, FILE* stream);
+void queue_message(Game* game, DealerMessage message, int id, int site, 
+	int points, int money, int card);
+void deliver_messages(Game* game, int id, DealerMessage message);
+void flush_messages(Game* game, int id);
+void write_parts(Process* process, struct iovec* parts, int count);
+void trim_log(Game* game);
+long long now_ms(void);
+int message_waiting(Game* game, Process* process);
+bool fill_inbox(Game* game, Process* process);
+bool take_message(Game* game, Process* process, Frame* frame);
+bool player_died(Game* game);
+bool wait_for_message(Game* game, int id, Frame* frame);
 int receive_message(Game* game, int id);
-int* handle_move(Game* game, int site, int id);
-char** initialise_board(Game* game);
-void update_board(char** board, Game* game);
-void display_board(char** board, Game* game);
-void shift_deck(Game* game);
-bool game_over(Game* game);
-void print_scores(Game* game);
-int card_score(Game* game, int id);
-void shift_site_players(Game* game, int id, int nextSite);
 
 #endif
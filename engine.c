@@ -0,0 +1,67 @@
+#include "engine.h"
+#include "site.h"
+#include "player.h"
+
+/*
+ * Parse the deck and path once and set up a game between the given seats
+ * Exit if the deck or path is invalid, as the dealer would
+ * */
+void initialise_engine(Engine* engine, char* deckBuffer, char* pathBuffer,
+	Strategy* seats, int numPlayers) {
+    Game* game = &engine->game;
+    int deckSize, argc = numPlayers + PROGRAM_ARGS;
+
+    char* deck = check_deckfile(deckBuffer, &deckSize);
+    Site* sites = create_sites(game, pathBuffer, argc);
+    initialise_game(game, deck, deckSize, sites, argc);
+    engine->path.pathSize = game->pathSize;
+    engine->path.types = game->types;
+    engine->path.sites = game->sites;
+    engine->path.links = game->links;
+    index_path(&engine->path);
+    engine->seats = seats;
+}
+
+/*
+ * Put the game back into its starting state: the first card of the deck 
+ * next, every player on the first site with their starting money
+ * */
+void reset_engine(Engine* engine) {
+    reset_game(&engine->game);
+    engine->path.lowest = 0;
+}
+
+/*
+ * Play one game to completion, asking each seat's strategy for its move
+ * in place of a YT message
+ * The final scores are left in the points of each player
+ * */
+void run_game(Engine* engine) {
+    Game* game = &engine->game;
+    int move[3];
+
+    reset_engine(engine);
+    while (!game_over(game)) {
+        int pID = next_player(game);
+        int site = engine->seats[pID](&engine->path, &game->players, pID,
+		game->numPlayers);
+        handle_move(game, site, pID, move);
+    }
+
+    score_game(game);
+}
+
+/*
+ * Release everything allocated by initialise_engine
+ * */
+void free_engine(Engine* engine) {
+    Game* game = &engine->game;
+
+    free(game->sites);
+    free(game->types);
+    free_players(&game->players);
+    free(game->processes);
+    free(game->links);
+    free(game->pollFds);
+    free(engine->path.next);
+}
@@ -0,0 +1,24 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include "common.h"
+#include "game.h"
+#include "strategy.h"
+
+/*
+ * Runs games between strategies inside a single process, without any
+ * player processes or pipes
+ * */
+typedef struct {
+    Game game;
+    Path path;
+    Strategy* seats;
+} Engine;
+
+void initialise_engine(Engine* engine, char* deckBuffer, char* pathBuffer,
+	Strategy* seats, int numPlayers);
+void reset_engine(Engine* engine);
+void run_game(Engine* engine);
+void free_engine(Engine* engine);
+
+#endif
@@ -0,0 +1,394 @@
+#include "game.h"
+#include "site.h"
+#include <limits.h>
+#include "compiled.h"
+#include "score.h"
+#include "player.h"
+
+/*
+ * Map a deck or path file, or its compiled form if that is up to date
+ * A file that is compiled itself is only used once map_compiled has checked
+ * that it is complete, and one that only starts like a compiled file is 
+ * refused, so that check_deckfile and create_sites can trust any compiled 
+ * header they are given
+ * Return the contents of the file or NULL if it cannot be used
+ * */
+char* map_game_file(char* fileName, int kind) {
+    char* buffer = (char*)map_fresh_compiled(fileName, kind);
+    long long length;
+
+    if (!buffer) {
+        buffer = (char*)map_compiled(fileName, kind);
+    }
+    if (!buffer && (buffer = map_file(fileName, &length)) && 
+	    !strncmp(buffer, COMPILED_MAGIC, strlen(COMPILED_MAGIC))) {
+        unmap_file(buffer, length);
+        buffer = NULL;
+    }
+    return buffer;
+}
+
+/*
+ * Parse the deckfile, using its compiled form instead if that is up to date
+ * Return the deckfile as a string on success or exit if there was an 
+ * issue with the deckfile
+ * */
+char* read_deckfile(char* fileName) {
+    char* buffer = map_game_file(fileName, COMPILED_DECK);
+
+    if (!buffer) {
+        fprintf(stderr, "Error reading deck\n");
+        exit(2);
+    }
+    return buffer;
+}
+
+/*
+ * Parse the pathfile, using its compiled form instead if that is up to date
+ * Return the contents of the pathfile as a string on success or exit if there 
+ * was an issue with the pathfile
+ * */
+char* read_pathfile(char* fileName) {
+    char* buffer = map_game_file(fileName, COMPILED_PATH);
+
+    if (!buffer) {
+        fprintf(stderr, "Error reading path\n");
+        exit(3);
+    }
+    return buffer;
+}
+
+/*
+ * Ensure that the contents of the deckfile are valid in a single pass over
+ * the cards
+ * A compiled deck was checked when it was compiled, and by map_compiled 
+ * when it was read, and is used as it is
+ * Return the cards of the deck, which stay in the buffer, on success or 
+ * exit if the cards in the deck are invalid, the number of cards is stored 
+ * in deckSize
+ * */
+char* check_deckfile(char* buffer, int* deckSize) {
+    char* deck;
+    long i, size;
+
+    if (is_compiled(buffer, COMPILED_DECK)) {
+        *deckSize = ((CompiledHeader*)buffer)->count;
+        return compiled_cards((CompiledHeader*)buffer);
+    }
+    size = strtol(buffer, &deck, 10);
+    if (deck == buffer || size < 1 || size > INT_MAX) {
+        fprintf(stderr, "Error reading deck\n");
+        exit(2);
+    }
+    // Running out of cards stops at the null byte after the file
+    for (i = 0; i < size; i++) {
+        if (deck[i] < 'A' || deck[i] > 'E') {
+            fprintf(stderr, "Error reading deck\n");
+            exit(2);
+        }
+    }
+    *deckSize = size;
+
+    return deck;
+}
+
+/*
+ * Ensure that the contents of the pathfile, or its compiled form, are valid
+ * and create the sites in the path
+ * Return an array of the sites on success or exit if the sites are invalid
+ * */
+Site* create_sites(Game* game, char* buffer, int argc) {
+    int pathSize;
+    char dummy;
+    bool compiled = is_compiled(buffer, COMPILED_PATH);
+
+    if (compiled) {
+        pathSize = ((CompiledHeader*)buffer)->count;
+    } else if (sscanf(buffer, "%d%c", &pathSize, &dummy) != 2 || 
+	    dummy != ';' || pathSize < 1) {
+        fprintf(stderr, "Error reading path\n");
+        exit(3);
+    }
+
+    Site* sites = (Site*)malloc(sizeof(Site) * pathSize);
+    game->types = (unsigned char*)malloc(sizeof(unsigned char) * pathSize);
+    if (!(compiled ? load_compiled_path((CompiledHeader*)buffer, sites, 
+	    game->types, argc - PROGRAM_ARGS) : parse_sites(strchr(buffer, 
+	    ';') + 1, sites, game->types, pathSize, argc - PROGRAM_ARGS)) || 
+	    !valid_path(game, sites, pathSize, argc)) {
+        fprintf(stderr, "Error reading path\n");
+        exit(3);
+    }
+
+    game->pathSize = pathSize;
+    return sites;
+}
+
+/*
+ * Check to see if the path is valid
+ * Returns true if the path is valid and false if it is invalid
+ * */
+bool valid_path(Game* game, Site* sites, int pathSize, int argc) {
+    int i;
+
+    for (i = 0; i < pathSize; i++) {
+        if (sites[i].limit < 0) {
+            return false;
+        }          
+    }
+
+    if (game->types[0] != SITE_BARRIER || 
+	    game->types[pathSize - 1] != SITE_BARRIER || 
+	    sites[0].limit != argc - PROGRAM_ARGS || 
+	    sites[pathSize - 1].limit != argc - PROGRAM_ARGS) {
+        return false;
+    }
+
+    return true;
+}
+
+/*
+ * Initialise the structure members of the game
+ * */
+void initialise_game(Game* game, char* deck, int deckSize, Site* sites, 
+	int argc) {
+    game->sites = sites;
+    game->deck = deck;
+    game->deckSize = deckSize;
+    game->drawn = 0;
+    game->numPlayers = argc - PROGRAM_ARGS;
+    create_players(&game->players, game->numPlayers);
+    game->processes = (Process*)calloc(game->numPlayers, sizeof(Process));
+    game->links = (Link*)malloc(sizeof(Link) * game->numPlayers);
+    game->lowest = 0;
+    game->pollFds = (struct pollfd*)malloc(sizeof(struct pollfd) * 
+	    (game->numPlayers + 1));
+    game->sighup = false;
+    game->timeout = -1;
+    game->binary = false;
+    game->log = NULL;
+    game->logSize = 0;
+    game->logCapacity = 0;
+    game->shared = NULL;
+    game->sharedName = NULL;
+    game->compiledName = NULL;
+    game->latencies = NULL;
+    game->statsName = NULL;
+    game->profile = NULL;
+    game->trace = NULL;
+    game->newGames = false;
+}
+
+/*
+ * Find the player whose turn it is: the player furthest behind, or the 
+ * player who arrived last at that site if several players are there
+ * Return the ID of that player
+ * */
+int next_player(Game* game) {
+    return game->sites[lowest_site(game)].last;
+}
+
+/*
+ * Find the site furthest back that has a player on it
+ * Players only ever move forward, so the search carries on from where it 
+ * last stopped rather than starting from the first site each turn
+ * Return the position of that site
+ * */
+int lowest_site(Game* game) {
+    while (game->lowest < game->pathSize - 1 && 
+	    !game->sites[game->lowest].count) {
+        game->lowest++;
+    }
+
+    return game->lowest;
+}
+
+/*
+ * What happens to a player who lands on each type of site, indexed by type
+ * */
+void (*const siteVisits[SITE_TYPES])(Game* game, int id, int* move) = {
+    visit_barrier, visit_mo, visit_v1, visit_v2, visit_do, visit_ri
+};
+
+/*
+ * Carry out a move when a player has chosen their next site
+ * Update the structure members of the players depending on the site they 
+ * move to
+ * Store the values for members to be changed for that player in move 
+ * (points, money, card)
+ * */
+void handle_move(Game* game, int site, int id, int* move) {
+    move[0] = 0;
+    move[1] = 0;
+    move[2] = 0;
+    siteVisits[game->types[site]](game, id, move);
+    shift_site_players(game, id, site);
+}
+
+/*
+ * A barrier changes nothing
+ * */
+void visit_barrier(Game* game, int id, int* move) {
+}
+
+/*
+ * A Mo site gives the player 3 money
+ * */
+void visit_mo(Game* game, int id, int* move) {
+    move[1] = 3;
+    game->players.money[id] += 3;
+}
+
+/*
+ * A V1 site counts towards the player's V1 total
+ * */
+void visit_v1(Game* game, int id, int* move) {
+    game->players.v1[id]++;
+}
+
+/*
+ * A V2 site counts towards the player's V2 total
+ * */
+void visit_v2(Game* game, int id, int* move) {
+    game->players.v2[id]++;
+}
+
+/*
+ * A Do site turns all of the player's money into a point for every 2 money
+ * */
+void visit_do(Game* game, int id, int* move) {
+    move[0] = game->players.money[id] / 2;
+    move[1] = -game->players.money[id];
+    game->players.points[id] += game->players.money[id] / 2;
+    game->players.money[id] = 0;
+}
+
+/*
+ * A Ri site gives the player the card at the top of the deck
+ * */
+void visit_ri(Game* game, int id, int* move) {
+    char card = draw_card(game);
+
+    if (card == 'A') {
+        move[2] = 1;
+        game->players.a[id]++;
+    } else if (card == 'B') {
+        move[2] = 2;
+        game->players.b[id]++;
+    } else if (card == 'C') {
+        move[2] = 3;
+        game->players.c[id]++;
+    } else if (card == 'D') {
+        move[2] = 4;
+        game->players.d[id]++;
+    } else {
+        move[2] = 5;
+        game->players.e[id]++;
+    }
+}
+
+/*
+ * Remove the player with the specified ID from one site and add them
+ * to the site that they would like to move to
+ * */
+void shift_site_players(Game* game, int id, int nextSite) {
+    remove_player(&game->sites[game->players.position[id]], game->links, 
+	    id);
+    add_player(&game->sites[nextSite], game->links, id);
+    game->players.position[id] = nextSite;
+}
+
+/*
+ * Check to see if the specified site is full
+ * Return true if it is full (limit is reached) and false otherwise
+ * */
+bool site_full(Game* game, int site) {
+    return game->sites[site].count >= game->sites[site].limit;
+}
+
+/*
+ * Draw the next card from the deck, going back to the first card once 
+ * every card has been drawn
+ * The deck itself never changes
+ * Return the card drawn
+ * */
+char draw_card(Game* game) {
+    char card = game->deck[game->drawn];
+
+    if (++game->drawn == game->deckSize) {
+        game->drawn = 0;
+    }
+    return card;
+}
+
+/*
+ * Place every player on the first site, highest ID first
+ * */
+void initialise_positions(Game* game) {
+    int r;
+
+    for (r = game->numPlayers - 1; r >= 0; r--) {
+        add_player(&game->sites[0], game->links, r);
+        game->players.position[r] = 0;
+    }
+    game->lowest = 0;
+}
+
+/*
+ * Put the game back into its starting state: the first card of the deck 
+ * next, every player on the first site with their starting money
+ * */
+void reset_game(Game* game) {
+    int i;
+
+    game->drawn = 0;
+    for (i = 0; i < game->pathSize; i++) {
+        clear_site(&game->sites[i]);
+    }
+    for (i = 0; i < game->numPlayers; i++) {
+        reset_player(&game->players, i);
+    }
+    initialise_positions(game);
+}
+
+/*
+ * Check to see if the game is over
+ * Return true if all players are at the last site or false if the game 
+ * is still running
+ * */   
+bool game_over(Game* game) {
+    return lowest_site(game) == game->pathSize - 1;
+}
+
+/*
+ * Add the points from V sites and cards to each player at the end of the game
+ * The cards of every player are scored in one batch
+ * */
+void score_game(Game* game) {
+    Players* players = &game->players;
+    int i, *scores = (int*)malloc(sizeof(int) * game->numPlayers);
+
+    card_scores(players->a, players->b, players->c, players->d, players->e, 
+	    scores, game->numPlayers);
+    for (i = 0; i < game->numPlayers; i++) {
+        players->points[i] += players->v1[i] + players->v2[i] + scores[i];
+    }
+    free(scores);
+}
+
+/*
+ * Calculate and print the scores of for each player at the end of the game
+ * */
+void print_scores(Game* game) {
+    int i;
+
+    score_game(game);
+    printf("Scores: ");
+    for (i = 0; i < game->numPlayers; i++) {
+        if (i == game->numPlayers - 1) {
+            printf("%d\n", game->players.points[i]);
+        } else {
+            printf("%d,", game->players.points[i]);
+        }
+    }
+}
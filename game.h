@@ -0,0 +1,32 @@
+#ifndef GAME_H
+#define GAME_H
+
+#include "common.h"
+
+char* map_game_file(char* fileName, int kind);
+char* read_deckfile(char* fileName);
+char* read_pathfile(char* fileName);
+char* check_deckfile(char* buffer, int* deckSize);
+Site* create_sites(Game* game, char* buffer, int argc);
+bool valid_path(Game* game, Site* sites, int pathSize, int argc);
+void initialise_game(Game* game, char* deck, int deckSize, Site* sites, 
+	int argc);
+void initialise_positions(Game* game);
+void reset_game(Game* game);
+int next_player(Game* game);
+int lowest_site(Game* game);
+void handle_move(Game* game, int site, int id, int* move);
+void visit_barrier(Game* game, int id, int* move);
+void visit_mo(Game* game, int id, int* move);
+void visit_v1(Game* game, int id, int* move);
+void visit_v2(Game* game, int id, int* move);
+void visit_do(Game* game, int id, int* move);
+void visit_ri(Game* game, int id, int* move);
+void shift_site_players(Game* game, int id, int nextSite);
+bool site_full(Game* game, int site);
+char draw_card(Game* game);
+bool game_over(Game* game);
+void score_game(Game* game);
+void print_scores(Game* game);
+
+#endif
@@ -0,0 +1,63 @@
+#include "player.h"
+
+/*
+ * Allocate the fields of every player and give each player its starting 
+ * values
+ * */
+void create_players(Players* players, int numPlayers) {
+    int i;
+
+    attach_players(players, (int*)malloc(sizeof(int) * PLAYER_FIELDS * 
+	    numPlayers), numPlayers);
+    for (i = 0; i < numPlayers; i++) {
+        reset_player(players, i);
+    }
+}
+
+/*
+ * Point the fields of the players at consecutive runs of numPlayers ints 
+ * in a block of PLAYER_FIELDS runs, such as one in shared memory
+ * */
+void attach_players(Players* players, int* fields, int numPlayers) {
+    players->position = fields;
+    players->money = fields + numPlayers;
+    players->v1 = fields + 2 * numPlayers;
+    players->v2 = fields + 3 * numPlayers;
+    players->points = fields + 4 * numPlayers;
+    players->a = fields + 5 * numPlayers;
+    players->b = fields + 6 * numPlayers;
+    players->c = fields + 7 * numPlayers;
+    players->d = fields + 8 * numPlayers;
+    players->e = fields + 9 * numPlayers;
+}
+
+/*
+ * Give a player the values that they start the game with
+ * */
+void reset_player(Players* players, int id) {
+    players->position[id] = 0;
+    players->money[id] = 7;
+    players->v1[id] = 0;
+    players->v2[id] = 0;
+    players->points[id] = 0;
+    players->a[id] = 0;
+    players->b[id] = 0;
+    players->c[id] = 0;
+    players->d[id] = 0;
+    players->e[id] = 0;
+}
+
+/*
+ * Copy every field of every player from one set of players to another
+ * */
+void copy_players(Players* to, Players* from, int numPlayers) {
+    memcpy(to->position, from->position, sizeof(int) * PLAYER_FIELDS * 
+	    numPlayers);
+}
+
+/*
+ * Release the fields of players made by create_players
+ * */
+void free_players(Players* players) {
+    free(players->position);
+}
@@ -0,0 +1,12 @@
+#ifndef PLAYER_H
+#define PLAYER_H
+
+#include "common.h"
+
+void create_players(Players* players, int numPlayers);
+void attach_players(Players* players, int* fields, int numPlayers);
+void reset_player(Players* players, int id);
+void copy_players(Players* to, Players* from, int numPlayers);
+void free_players(Players* players);
+
+#endif
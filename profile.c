@@ -0,0 +1,70 @@
+#include "profile.h"
+#include "stats.h"
+#include <time.h>
+
+/*
+ * The name of each phase as it is printed
+ * */
+const char* const phaseNames[PHASES] = {"read deck and path", "create_sites",
+	"initialise_players", "send_path", "turn loop", "render", 
+	"print_scores", "shutdown"};
+
+/*
+ * Return a profile with nothing timed yet
+ * */
+Profile* create_profile(void) {
+    return (Profile*)calloc(1, sizeof(Profile));
+}
+
+/*
+ * Note the time at which a phase is entered
+ * Does nothing if there is no profile, so that callers need not check
+ * */
+void start_phase(Profile* profile, Phase phase) {
+    if (profile) {
+        profile->wallStart[phase] = clock_ns();
+        profile->cpuStart[phase] = cpu_ns();
+    }
+}
+
+/*
+ * Add the time since a phase was entered to its totals
+ * Does nothing if there is no profile
+ * */
+void end_phase(Profile* profile, Phase phase) {
+    if (profile) {
+        profile->calls[phase]++;
+        profile->wall[phase] += clock_ns() - profile->wallStart[phase];
+        profile->cpu[phase] += cpu_ns() - profile->cpuStart[phase];
+    }
+}
+
+/*
+ * Return the CPU time used by this process, not counting its children, in
+ * nanoseconds
+ * */
+long long cpu_ns(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+    return now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+/*
+ * Print the number of times each phase was entered and the wall clock and 
+ * CPU time spent in it
+ * send_path is part of initialise_players, and render is part of the turn 
+ * loop
+ * */
+void print_profile(Profile* profile, FILE* out) {
+    int i;
+
+    fprintf(out, "%-20s %10s %12s %12s\n", "phase", "calls", "wall ms", 
+	    "cpu ms");
+    for (i = 0; i < PHASES; i++) {
+        fprintf(out, "%-20s %10lld %12.3f %12.3f\n", phaseNames[i], 
+		profile->calls[i], profile->wall[i] / 1e6, 
+		profile->cpu[i] / 1e6);
+    }
+    fflush(out);
+}
@@ -0,0 +1,14 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "common.h"
+
+extern const char* const phaseNames[PHASES];
+
+Profile* create_profile(void);
+void start_phase(Profile* profile, Phase phase);
+void end_phase(Profile* profile, Phase phase);
+long long cpu_ns(void);
+void print_profile(Profile* profile, FILE* out);
+
+#endif
@@ -0,0 +1,72 @@
+#include "protocol.h"
+
+/*
+ * Write a message into buffer using either the text or binary protocol
+ * buffer must hold at least MAX_MSG_SIZE characters
+ * Return the number of bytes to send
+ * */
+int encode_message(Frame* frame, bool binary, char* buffer) {
+    if (binary) {
+        memcpy(buffer, frame, sizeof(Frame));
+        return sizeof(Frame);
+    }
+
+    switch (frame->type) {
+        case YT:
+            return sprintf(buffer, "YT\n");
+        case EARLY:
+            return sprintf(buffer, "EARLY\n");
+        case DONE:
+            return sprintf(buffer, "DONE\n");
+        case HAP:
+            return sprintf(buffer, "HAP%d,%d,%d,%d,%d\n", frame->id, 
+		    frame->site, frame->points, frame->money, frame->card);
+        case DO:
+            return sprintf(buffer, "DO%d\n", frame->site);
+        case NEWGAME:
+            return sprintf(buffer, "NEWGAME\n");
+    }
+
+    return 0;
+}
+
+/*
+ * Parse one line of the text protocol, without its newline, into a frame
+ * Return true on success or false if the line is not a valid message
+ * */
+bool decode_line(char* line, Frame* frame) {
+    int card;
+    char dummy;
+
+    memset(frame, 0, sizeof(Frame));
+    if (!strcmp(line, "YT")) {
+        frame->type = YT;
+    } else if (!strcmp(line, "EARLY")) {
+        frame->type = EARLY;
+    } else if (!strcmp(line, "DONE")) {
+        frame->type = DONE;
+    } else if (!strcmp(line, "NEWGAME")) {
+        frame->type = NEWGAME;
+    } else if (sscanf(line, "HAP%d,%d,%d,%d,%d%c", &frame->id, &frame->site, 
+	    &frame->points, &frame->money, &card, &dummy) == 5 && card >= 0 &&
+	    card <= 5) {
+        frame->type = HAP;
+        frame->card = card;
+    } else if (sscanf(line, "DO%d%c", &frame->site, &dummy) == 1) {
+        frame->type = DO;
+    } else {
+        frame->type = BAD_MESSAGE;
+        return false;
+    }
+
+    return true;
+}
+
+/*
+ * Check that a frame read from the binary protocol is one of the known 
+ * messages
+ * Return true if it is and false otherwise
+ * */
+bool valid_frame(Frame* frame) {
+    return frame->type <= NEWGAME && frame->reserved == 0;
+}
@@ -0,0 +1,16 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include "common.h"
+
+#define BINARY_OFFER "^B\n"
+#define BINARY_ACCEPT 'B'
+#define NEWGAME_OFFER "^N\n"
+#define NEWGAME_ACCEPT 'N'
+#define BAD_MESSAGE 0xff
+
+int encode_message(Frame* frame, bool binary, char* buffer);
+bool decode_line(char* line, Frame* frame);
+bool valid_frame(Frame* frame);
+
+#endif
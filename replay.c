@@ -0,0 +1,112 @@
+#include "replay.h"
+#include "site.h"
+#include "player.h"
+
+/*
+ * Set up the game that a trace was recorded from, with every player on 
+ * the first site
+ * Return false if the path or the deck of the trace is not one that the 
+ * dealer would have played
+ * */
+bool initialise_replay(TraceReplay* replay, TraceHeader* header, 
+	long long length) {
+    Game* game = &replay->game;
+    int i, argc = header->numPlayers + PROGRAM_ARGS;
+    int* limits = trace_limits(header);
+    char* deck = trace_deck(header);
+
+    for (i = 0; i < header->deckSize; i++) {
+        if (deck[i] < 'A' || deck[i] > 'E') {
+            return false;
+        }
+    }
+    game->pathSize = header->pathSize;
+    game->types = (unsigned char*)malloc(sizeof(unsigned char) * 
+	    header->pathSize);
+    memcpy(game->types, trace_types(header), header->pathSize);
+    Site* sites = (Site*)malloc(sizeof(Site) * header->pathSize);
+    for (i = 0; i < header->pathSize; i++) {
+        clear_site(&sites[i]);
+        sites[i].limit = game->types[i] < SITE_TYPES ? limits[i] : EMPTY;
+    }
+    if (!valid_path(game, sites, header->pathSize, argc)) {
+        free(game->types);
+        free(sites);
+        return false;
+    }
+
+    initialise_game(game, deck, header->deckSize, sites, argc);
+    replay->header = header;
+    replay->records = trace_records(header);
+    replay->turns = (length - header->recordsOffset) / sizeof(TraceRecord);
+    reset_replay(replay);
+
+    return true;
+}
+
+/*
+ * Put the game back to before the first turn of the trace
+ * */
+void reset_replay(TraceReplay* replay) {
+    reset_game(&replay->game);
+    replay->turn = 0;
+}
+
+/*
+ * Make the move of the next record of the trace with handle_move, as the 
+ * dealer did
+ * Return false if there are no records left, if it was not that player's 
+ * turn or the dealer would have refused the move, all without making the 
+ * move, or if the points, money or card recorded differ from what the move 
+ * gave
+ * */
+bool replay_turn(TraceReplay* replay) {
+    Game* game = &replay->game;
+    TraceRecord* record = &replay->records[replay->turn];
+    int move[3];
+
+    if (replay->turn == replay->turns || game_over(game) || 
+	    record->id != next_player(game) || 
+	    record->site <= game->players.position[record->id] || 
+	    record->site >= game->pathSize || site_full(game, record->site)) {
+        return false;
+    }
+    handle_move(game, record->site, record->id, move);
+    replay->turn++;
+
+    return move[0] == record->points && move[1] == record->money && 
+	    move[2] == record->card;
+}
+
+/*
+ * Replay the trace up to the given turn, starting again from the first 
+ * turn if it has already been passed
+ * Return false if a record on the way does not replay
+ * */
+bool seek_replay(TraceReplay* replay, long long turn) {
+    if (turn < replay->turn) {
+        reset_replay(replay);
+    }
+    while (replay->turn < turn) {
+        if (!replay_turn(replay)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Release everything allocated by initialise_replay
+ * The trace itself is left mapped
+ * */
+void free_replay(TraceReplay* replay) {
+    Game* game = &replay->game;
+
+    free(game->sites);
+    free(game->types);
+    free_players(&game->players);
+    free(game->processes);
+    free(game->links);
+    free(game->pollFds);
+}
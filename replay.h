@@ -0,0 +1,28 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "common.h"
+#include "game.h"
+#include "trace.h"
+
+/*
+ * Replays the turns of a trace on a game of its own, without any player 
+ * processes
+ * turn is the number of records replayed so far
+ * */
+typedef struct {
+    Game game;
+    TraceHeader* header;
+    TraceRecord* records;
+    long long turns;
+    long long turn;
+} TraceReplay;
+
+bool initialise_replay(TraceReplay* replay, TraceHeader* header, 
+	long long length);
+void reset_replay(TraceReplay* replay);
+bool replay_turn(TraceReplay* replay);
+bool seek_replay(TraceReplay* replay, long long turn);
+void free_replay(TraceReplay* replay);
+
+#endif
@@ -0,0 +1,90 @@
+#include "score.h"
+#ifdef __SSE2__
+#include <immintrin.h>
+#endif
+
+/*
+ * Calculate the points that a player gains from the cards that they have
+ * Return the points that they gain
+ * */
+int card_score(Players* players, int id) {
+    return set_score(players->a[id], players->b[id], players->c[id], 
+	    players->d[id], players->e[id]);
+}
+
+/*
+ * Score a hand of cards as sets of different cards, largest sets first
+ * Sets of 1 to 5 cards are worth 1, 3, 5, 7 and 10 points
+ * With the counts sorted from most to fewest, the ith most common card adds
+ * 1, 2, 2, 2 or 3 points to the sets it is in, which comes to twice the 
+ * cards held, less the most common count and plus the least common count
+ * Return the points for the hand
+ * */
+int set_score(int a, int b, int c, int d, int e) {
+    int most = a, fewest = a;
+
+    most = b > most ? b : most;
+    most = c > most ? c : most;
+    most = d > most ? d : most;
+    most = e > most ? e : most;
+    fewest = b < fewest ? b : fewest;
+    fewest = c < fewest ? c : fewest;
+    fewest = d < fewest ? d : fewest;
+    fewest = e < fewest ? e : fewest;
+
+    return 2 * (a + b + c + d + e) - most + fewest;
+}
+
+/*
+ * Score many hands at once, where the counts of each card for every hand 
+ * are held in one array per card
+ * Hands are scored eight at a time with AVX2 or four at a time with SSE2 
+ * when the compiler targets them, and the rest one at a time
+ * */
+void card_scores(int* a, int* b, int* c, int* d, int* e, int* scores, 
+	int count) {
+    int i = 0;
+
+#if defined(__AVX2__)
+    for (; i + 8 <= count; i += 8) {
+        __m256i va = _mm256_loadu_si256((__m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((__m256i*)(b + i));
+        __m256i vc = _mm256_loadu_si256((__m256i*)(c + i));
+        __m256i vd = _mm256_loadu_si256((__m256i*)(d + i));
+        __m256i ve = _mm256_loadu_si256((__m256i*)(e + i));
+        __m256i most = _mm256_max_epi32(_mm256_max_epi32(va, vb), 
+		_mm256_max_epi32(_mm256_max_epi32(vc, vd), ve));
+        __m256i fewest = _mm256_min_epi32(_mm256_min_epi32(va, vb), 
+		_mm256_min_epi32(_mm256_min_epi32(vc, vd), ve));
+        __m256i total = _mm256_add_epi32(_mm256_add_epi32(va, vb), 
+		_mm256_add_epi32(_mm256_add_epi32(vc, vd), ve));
+        _mm256_storeu_si256((__m256i*)(scores + i), _mm256_add_epi32(
+		_mm256_sub_epi32(_mm256_slli_epi32(total, 1), most), fewest));
+    }
+#elif defined(__SSE2__)
+    // SSE2 has no 32 bit min or max, so each is a compare and a select
+    for (; i + 4 <= count; i += 4) {
+        __m128i v[5] = {_mm_loadu_si128((__m128i*)(a + i)), 
+		_mm_loadu_si128((__m128i*)(b + i)), 
+		_mm_loadu_si128((__m128i*)(c + i)), 
+		_mm_loadu_si128((__m128i*)(d + i)), 
+		_mm_loadu_si128((__m128i*)(e + i))};
+        __m128i most = v[0], fewest = v[0], total = v[0];
+        int k;
+        for (k = 1; k < 5; k++) {
+            __m128i more = _mm_cmpgt_epi32(v[k], most);
+            __m128i less = _mm_cmpgt_epi32(fewest, v[k]);
+            most = _mm_or_si128(_mm_and_si128(more, v[k]), 
+		    _mm_andnot_si128(more, most));
+            fewest = _mm_or_si128(_mm_and_si128(less, v[k]), 
+		    _mm_andnot_si128(less, fewest));
+            total = _mm_add_epi32(total, v[k]);
+        }
+        _mm_storeu_si128((__m128i*)(scores + i), _mm_add_epi32(
+		_mm_sub_epi32(_mm_slli_epi32(total, 1), most), fewest));
+    }
+#endif
+    for (; i < count; i++) {
+        scores[i] = set_score(a[i], b[i], c[i], d[i], e[i]);
+    }
+}
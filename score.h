@@ -0,0 +1,11 @@
+#ifndef SCORE_H
+#define SCORE_H
+
+#include "common.h"
+
+int card_score(Players* players, int id);
+int set_score(int a, int b, int c, int d, int e);
+void card_scores(int* a, int* b, int* c, int* d, int* e, int* scores, 
+	int count);
+
+#endif
@@ -0,0 +1,135 @@
+#include "shared.h"
+
+/*
+ * Create and map a named shared memory region big enough for every player,
+ * every site, the links between players on the same site and the types of 
+ * the sites
+ * Return the mapped state or NULL if the region could not be created
+ * */
+SharedState* create_shared_state(char* name, int numPlayers, int pathSize) {
+    int size = sizeof(SharedState) + sizeof(int) * PLAYER_FIELDS * 
+	    numPlayers + sizeof(Site) * pathSize + sizeof(Link) * numPlayers + 
+	    sizeof(unsigned char) * pathSize;
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+
+    if (fd < 0) {
+        return NULL;
+    }
+    if (ftruncate(fd, size) < 0) {
+        close(fd);
+        shm_unlink(name);
+        return NULL;
+    }
+
+    SharedState* state = (SharedState*)mmap(NULL, size, 
+	    PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (state == MAP_FAILED) {
+        shm_unlink(name);
+        return NULL;
+    }
+
+    state->seq = 0;
+    state->numPlayers = numPlayers;
+    state->pathSize = pathSize;
+    state->size = size;
+    return state;
+}
+
+/*
+ * Map the region created by the dealer read only
+ * Return the mapped state or NULL if it could not be opened or is too small
+ * to be a game
+ * */
+SharedState* open_shared_state(char* name) {
+    struct stat info;
+    int fd = shm_open(name, O_RDONLY, 0);
+
+    if (fd < 0) {
+        return NULL;
+    }
+    if (fstat(fd, &info) < 0 || info.st_size < sizeof(SharedState)) {
+        close(fd);
+        return NULL;
+    }
+
+    SharedState* state = (SharedState*)mmap(NULL, info.st_size, PROT_READ, 
+	    MAP_SHARED, fd, 0);
+    close(fd);
+    if (state == MAP_FAILED || state->size != info.st_size) {
+        return NULL;
+    }
+    return state;
+}
+
+/*
+ * Return the fields of the players that follow the header, to be handed to
+ * attach_players
+ * */
+int* shared_players(SharedState* state) {
+    return (int*)(state + 1);
+}
+
+/*
+ * Return the array of sites that follows the players
+ * */
+Site* shared_sites(SharedState* state) {
+    return (Site*)(shared_players(state) + PLAYER_FIELDS * state->numPlayers);
+}
+
+/*
+ * Return the links between players that follow the sites
+ * */
+Link* shared_links(SharedState* state) {
+    return (Link*)(shared_sites(state) + state->pathSize);
+}
+
+/*
+ * Return the type of every site that follows the links
+ * */
+unsigned char* shared_types(SharedState* state) {
+    return (unsigned char*)(shared_links(state) + state->numPlayers);
+}
+
+/*
+ * Mark the state as being changed so that readers know to try again
+ * */
+void begin_write(SharedState* state) {
+    __atomic_store_n(&state->seq, state->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/*
+ * Mark the state as consistent again
+ * */
+void end_write(SharedState* state) {
+    __atomic_store_n(&state->seq, state->seq + 1, __ATOMIC_RELEASE);
+}
+
+/*
+ * Wait until the state is not being changed
+ * Return the version to hand to end_read, or 0 if there is no shared state
+ * */
+unsigned begin_read(SharedState* state) {
+    unsigned version;
+
+    if (!state) {
+        return 0;
+    }
+    while ((version = __atomic_load_n(&state->seq, __ATOMIC_ACQUIRE)) & 1) {
+    }
+    return version;
+}
+
+/*
+ * Check whether the state changed while it was being read
+ * Return true if what was read is consistent and false if it must be read 
+ * again
+ * */
+bool end_read(SharedState* state, unsigned version) {
+    if (!state) {
+        return true;
+    }
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&state->seq, __ATOMIC_RELAXED) == version;
+}
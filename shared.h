@@ -0,0 +1,21 @@
+#ifndef SHARED_H
+#define SHARED_H
+
+#include "common.h"
+#include <sys/mman.h>
+
+#define SHARED_OFFER "^S"
+#define SHARED_ACCEPT 'S'
+
+SharedState* create_shared_state(char* name, int numPlayers, int pathSize);
+SharedState* open_shared_state(char* name);
+int* shared_players(SharedState* state);
+Site* shared_sites(SharedState* state);
+Link* shared_links(SharedState* state);
+unsigned char* shared_types(SharedState* state);
+void begin_write(SharedState* state);
+void end_write(SharedState* state);
+unsigned begin_read(SharedState* state);
+bool end_read(SharedState* state, unsigned version);
+
+#endif
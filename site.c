@@ -0,0 +1,119 @@
+#include "site.h"
+
+/*
+ * The name of each type of site as it appears in a path
+ * */
+const char* const siteNames[SITE_TYPES] = {"::", "Mo", "V1", "V2", "Do", 
+	"Ri"};
+
+/*
+ * Parse the sites of a path, each a two character type followed by a limit
+ * that is either '-' or a number of players
+ * The type of each site is stored in types
+ * A limit of '-' or more than the number of players becomes the number of 
+ * players
+ * Return true if there were enough sites of known types and false otherwise
+ * */
+bool parse_sites(char* text, Site* sites, unsigned char* types, 
+	int pathSize, int numPlayers) {
+    int i, type;
+
+    for (i = 0; i < pathSize; i++) {
+        if (!text[0] || !text[1] || (type = site_type(text)) == EMPTY) {
+            return false;
+        }
+        types[i] = type;
+        text += TYPE_SIZE;
+
+        if (*text == '-') {
+            sites[i].limit = numPlayers;
+            text++;
+        } else if (isdigit(*text)) {
+            long limit = strtol(text, &text, 10);
+            sites[i].limit = limit > numPlayers ? numPlayers : limit;
+        } else {
+            return false;
+        }
+        clear_site(&sites[i]);
+    }
+
+    return true;
+}
+
+/*
+ * Look up the type of site named by the first two characters of text
+ * Return the type or EMPTY if it is not the name of a site
+ * */
+int site_type(char* text) {
+    int type;
+
+    for (type = 0; type < SITE_TYPES; type++) {
+        if (text[0] == siteNames[type][0] && text[1] == siteNames[type][1]) {
+            return type;
+        }
+    }
+
+    return EMPTY;
+}
+
+/*
+ * Build the table of the next site of each type after every site of the 
+ * path, working back from the end so that each entry is found in one step
+ * */
+void index_path(Path* path) {
+    int i, type, last = path->pathSize - 1;
+
+    path->next = (int (*)[SITE_TYPES])malloc(sizeof(*path->next) * 
+	    path->pathSize);
+    for (type = 0; type < SITE_TYPES; type++) {
+        path->next[last][type] = path->pathSize;
+    }
+    for (i = last - 1; i >= 0; i--) {
+        memcpy(path->next[i], path->next[i + 1], sizeof(*path->next));
+        path->next[i][path->types[i + 1]] = i + 1;
+    }
+    path->lowest = 0;
+}
+
+/*
+ * Remove every player from a site
+ * */
+void clear_site(Site* site) {
+    site->count = 0;
+    site->first = EMPTY;
+    site->last = EMPTY;
+}
+
+/*
+ * Add a player to a site as its most recent arrival
+ * The caller must check that the site has room
+ * */
+void add_player(Site* site, Link* links, int id) {
+    links[id].prev = site->last;
+    links[id].next = EMPTY;
+    if (site->last == EMPTY) {
+        site->first = id;
+    } else {
+        links[site->last].next = id;
+    }
+    site->last = id;
+    site->count++;
+}
+
+/*
+ * Remove a player from the site they are on, keeping everyone else in the 
+ * order they arrived
+ * */
+void remove_player(Site* site, Link* links, int id) {
+    if (links[id].prev == EMPTY) {
+        site->first = links[id].next;
+    } else {
+        links[links[id].prev].next = links[id].next;
+    }
+    if (links[id].next == EMPTY) {
+        site->last = links[id].prev;
+    } else {
+        links[links[id].next].prev = links[id].prev;
+    }
+    site->count--;
+}
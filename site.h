@@ -0,0 +1,16 @@
+#ifndef SITE_H
+#define SITE_H
+
+#include "common.h"
+
+extern const char* const siteNames[SITE_TYPES];
+
+bool parse_sites(char* text, Site* sites, unsigned char* types, 
+	int pathSize, int numPlayers);
+int site_type(char* text);
+void index_path(Path* path);
+void clear_site(Site* site);
+void add_player(Site* site, Link* links, int id);
+void remove_player(Site* site, Link* links, int id);
+
+#endif
@@ -0,0 +1,101 @@
+#include "stats.h"
+#include <time.h>
+
+/*
+ * Return the time in nanoseconds from an arbitrary starting point
+ * */
+long long clock_ns(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+/*
+ * Find the bucket for a time: small times have a bucket each, larger ones 
+ * go by their highest bit and the STATS_SUB_BITS bits below it
+ * Return the index of the bucket
+ * */
+int latency_bucket(long long ns) {
+    if (ns < STATS_SUB_BUCKETS) {
+        return ns < 0 ? 0 : ns;
+    }
+    int high = 63 - __builtin_clzll(ns);
+    int shift = high - STATS_SUB_BITS;
+
+    return ((shift + 1) << STATS_SUB_BITS) | 
+	    ((ns >> shift) & (STATS_SUB_BUCKETS - 1));
+}
+
+/*
+ * Return the largest time that falls in a bucket
+ * */
+long long bucket_limit(int bucket) {
+    if (bucket < STATS_SUB_BUCKETS) {
+        return bucket;
+    }
+    int shift = (bucket >> STATS_SUB_BITS) - 1;
+    long long low = (long long)(STATS_SUB_BUCKETS + 
+	    (bucket & (STATS_SUB_BUCKETS - 1))) << shift;
+
+    return low + (1LL << shift) - 1;
+}
+
+/*
+ * Count one answer that took the given time
+ * */
+void record_latency(Latency* latency, long long ns) {
+    latency->turns++;
+    latency->total += ns;
+    if (ns > latency->max) {
+        latency->max = ns;
+    }
+    latency->buckets[latency_bucket(ns)]++;
+}
+
+/*
+ * Find the time that the given fraction of answers took no longer than
+ * Return the largest time in the bucket holding that answer, or the 
+ * slowest answer if that is smaller, or 0 if there were no answers
+ * */
+long long latency_percentile(Latency* latency, double fraction) {
+    long long seen = 0, wanted = (long long)(fraction * latency->turns);
+    int i;
+
+    if (wanted < 1) {
+        wanted = 1;
+    }
+    for (i = 0; i < STATS_BUCKETS && latency->turns; i++) {
+        seen += latency->buckets[i];
+        if (seen >= wanted) {
+            long long limit = bucket_limit(i);
+            return limit < latency->max ? limit : latency->max;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Write one line of comma separated values for each player, with the 
+ * number of turns they answered and the mean, median, 99th percentile and
+ * largest time they took, in nanoseconds, after a heading line
+ * Return true if the file was written and false otherwise
+ * */
+bool write_stats(char* fileName, Latency* latencies, int numPlayers) {
+    FILE* out = fopen(fileName, "w");
+    int i;
+
+    if (!out) {
+        return false;
+    }
+    fprintf(out, "player,turns,mean_ns,p50_ns,p99_ns,max_ns\n");
+    for (i = 0; i < numPlayers; i++) {
+        Latency* latency = &latencies[i];
+        fprintf(out, "%d,%lld,%lld,%lld,%lld,%lld\n", i, latency->turns, 
+		latency->turns ? latency->total / latency->turns : 0, 
+		latency_percentile(latency, 0.5), 
+		latency_percentile(latency, 0.99), latency->max);
+    }
+
+    return fclose(out) == 0;
+}
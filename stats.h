@@ -0,0 +1,13 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include "common.h"
+
+long long clock_ns(void);
+int latency_bucket(long long ns);
+long long bucket_limit(int bucket);
+void record_latency(Latency* latency, long long ns);
+long long latency_percentile(Latency* latency, double fraction);
+bool write_stats(char* fileName, Latency* latencies, int numPlayers);
+
+#endif
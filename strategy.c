@@ -0,0 +1,236 @@
+#include "strategy.h"
+
+/*
+ * Decide on a move for a type A player: head for a Do site while holding 
+ * money, take the money on an adjacent Mo site, otherwise move to the 
+ * closest V site or barrier
+ * Return the site that the player has chosen to move to
+ * */
+int strategy_a(Path* path, Players* players, int id, int pCount) {
+    int nextSite, currentSite = players->position[id];
+
+    if (players->money[id] != 0 && do_site(path, players, id) && 
+	    !full_site(path, do_site(path, players, id))) {
+        nextSite = do_site(path, players, id);
+    } else if (next_mo_site(path, players, id) && !full_site(path, 
+	    currentSite + 1)) {
+        nextSite = currentSite + next_mo_site(path, players, id);
+    } else {
+        nextSite = v_site(path, players, id);
+    }
+
+    return nextSite;
+}
+
+/*
+ * Decide on a move for a type B player: step forward when furthest behind, 
+ * chase Mo sites with an odd amount of money, Ri sites when holding the 
+ * most cards and otherwise V2 sites or the closest free site
+ * Return the site that the player has chosen to move to
+ * */
+int strategy_b(Path* path, Players* players, int id, int pCount) {
+    int i, nextSite = 0, currentSite = players->position[id];
+
+    if (!full_site(path, currentSite + 1) && 
+	    last_player(path, players, id)) {
+        nextSite = currentSite + 1;
+    } else if (players->money[id] % 2 != 0 && mo_site(path, players, id)) {
+        nextSite = mo_site(path, players, id);
+    } else if ((most_cards(players, id, pCount) || no_cards(players, pCount))
+	    && ri_site(path, players, id)) {
+        nextSite = ri_site(path, players, id);
+    } else if (v2_site(path, players, id)) {
+        nextSite = v2_site(path, players, id);
+    } else {
+        for (i = 1; i < path->pathSize; i++) {
+            if (!full_site(path, currentSite + i)) {
+                nextSite = currentSite + i;
+                break;
+            }
+        }
+    }
+
+    return nextSite;
+}
+
+/*
+ * Look up a strategy by name, accepting either the letter of the player type 
+ * or the name of its program (e.g. "A", "2310A" or "./2310A")
+ * Return the strategy or NULL if there is no such player type
+ * */
+Strategy find_strategy(char* name) {
+    char* base = strrchr(name, '/');
+    base = base ? base + 1 : name;
+    if (!strncmp(base, "2310", 4)) {
+        base += 4;
+    }
+
+    if (!strcmp(base, "A")) {
+        return strategy_a;
+    } else if (!strcmp(base, "B")) {
+        return strategy_b;
+    }
+
+    return NULL;
+}
+
+/*
+ * Check to see if there is a valid V site that the player can move to
+ * Return the position of the V site on sucess or 0 if there is not a
+ * valid V site
+ * */
+int v_site(Path* path, Players* players, int id) {
+    int i = players->position[id];
+
+    while (i < path->pathSize - 1) {
+        int* next = path->next[i];
+        i = next[SITE_V1] < next[SITE_V2] ? next[SITE_V1] : next[SITE_V2];
+        if (next[SITE_BARRIER] < i) {
+            i = next[SITE_BARRIER];
+        }
+        if (!full_site(path, i)) {
+            return i;
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * Check to see if there is a valid barrier site for the player to move to
+ * Return the position of the closest barrier site
+ * */
+int barrier_site(Path* path, Players* players, int id) {
+    return path->next[players->position[id]][SITE_BARRIER];
+}
+
+/*
+ * Check to see if there is a valid Do site for the player to move to
+ * Return the position of the valid Do site or 0 if there is not one
+ * */
+int do_site(Path* path, Players* players, int id) {
+    int site = path->next[players->position[id]][SITE_DO];
+
+    return site < path->pathSize ? site : 0;
+}
+
+/*
+ * Check to see if there is a valid Mo site for the player to move to
+ * Return 1 if the next site is a valid Mo site or 0 if it is not
+ * */
+int next_mo_site(Path* path, Players* players, int id) {
+    if (path->types[players->position[id] + 1] == SITE_MO) {
+        return 1;
+    }
+
+    return 0;
+}
+
+/*
+ * Checks to see if there is a valid Mo site for the player to move to
+ * Returns the position of the valid Mo site or 0 if there isn't one
+ * */
+int mo_site(Path* path, Players* players, int id) {
+    return free_site_before_barrier(path, players->position[id], SITE_MO);
+}
+
+/*
+ * Check to see if there is a valid V2 site for the player to move to
+ * Returns the position of the valid V2 site or 0 if there isn't one
+ * */
+int v2_site(Path* path, Players* players, int id) {
+    return free_site_before_barrier(path, players->position[id], SITE_V2);
+}
+
+/*
+ * Check to see if there is a valid Ri site for the player to move to
+ * Returns the position of the valid Ri site or 0 if there isn't one
+ * */
+int ri_site(Path* path, Players* players, int id) {
+    return free_site_before_barrier(path, players->position[id], SITE_RI);
+}
+
+/*
+ * Find the closest site of a type after a position that is not full, 
+ * jumping from one site of that type to the next and giving up at the 
+ * next barrier
+ * Returns the position of the site or 0 if there isn't one
+ * */
+int free_site_before_barrier(Path* path, int position, int type) {
+    int barrier = path->next[position][SITE_BARRIER];
+    int site = path->next[position][type];
+
+    while (site < barrier) {
+        if (!full_site(path, site)) {
+            return site;
+        }
+        site = path->next[site][type];
+    }
+    return 0;
+}
+
+/*
+ * Checks to see if the specified player has the most cards
+ * Returns true if they have more cards than any other player and 
+ * false otherwise
+ * */
+bool most_cards(Players* players, int id, int pCount) {
+    int i, others = EMPTY;
+
+    for (i = 0; i < pCount; i++) {
+        int count = card_count(players, i);
+        if (i != id && count > others) {
+            others = count;
+        }
+    }
+    return card_count(players, id) > others;
+}
+
+/*
+ * Counts the cards that the specified player holds
+ * Returns the number of cards
+ * */
+int card_count(Players* players, int id) {
+    return players->a[id] + players->b[id] + players->c[id] + 
+	    players->d[id] + players->e[id];
+}
+
+/*
+ * Checks to see if all of the players in the game have no cards
+ * Returns true if all players have 0 cards and false otherwise
+ * */
+bool no_cards(Players* players, int pCount) {
+    int i;
+
+    for (i = 0; i < pCount; i++) {
+        if (players->a[i] || players->b[i] || players->c[i] || players->d[i] ||
+		players->e[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Checks to see if the player is furthest behind on their own
+ * Players only ever move forward, so the search for the site furthest back 
+ * with a player on it carries on from where it last stopped
+ * Returns true if the player is last and false otherwise
+ * */
+bool last_player(Path* path, Players* players, int id) {
+    int position = players->position[id];
+
+    while (path->lowest < position && !path->sites[path->lowest].count) {
+        path->lowest++;
+    }
+
+    return path->lowest == position && path->sites[position].count == 1;
+}
+
+/*
+ * Checks to see if the specified site is full
+ * Returns true if the site is full (limit is reached) and false otherwise
+ * */
+bool full_site(Path* path, int site) {
+    return path->sites[site].count >= path->sites[site].limit;
+}
@@ -0,0 +1,28 @@
+#ifndef STRATEGY_H
+#define STRATEGY_H
+
+#include "common.h"
+
+/*
+ * Decides on the site a player moves to without changing any state
+ * */
+typedef int (*Strategy)(Path* path, Players* players, int id, int pCount);
+
+int strategy_a(Path* path, Players* players, int id, int pCount);
+int strategy_b(Path* path, Players* players, int id, int pCount);
+Strategy find_strategy(char* name);
+int v_site(Path* path, Players* players, int id);
+int barrier_site(Path* path, Players* players, int id);
+int do_site(Path* path, Players* players, int id);
+int next_mo_site(Path* path, Players* players, int id);
+int mo_site(Path* path, Players* players, int id);
+int v2_site(Path* path, Players* players, int id);
+int ri_site(Path* path, Players* players, int id);
+int free_site_before_barrier(Path* path, int position, int type);
+bool most_cards(Players* players, int id, int pCount);
+int card_count(Players* players, int id);
+bool no_cards(Players* players, int pCount);
+bool last_player(Path* path, Players* players, int id);
+bool full_site(Path* path, int site);
+
+#endif
@@ -0,0 +1,58 @@
+#!/bin/bash
+# Check that the dealer and 2310sim refuse compiled decks and paths that 
+# are incomplete or claim more than they hold, rather than trusting them
+# Usage: test/compiled.sh, from the directory holding the programs
+
+dir=$(mktemp -d)
+trap 'rm -rf "$dir"' EXIT
+failed=0
+
+printf '7ABCDEAB\n' > "$dir/deck"
+printf '6;::-Mo1V11V2-Ri1::-\n' > "$dir/path"
+./2310compile "$dir/deck" "$dir/path" > /dev/null || exit 1
+
+# expect name status message program {argument}
+# Run a program and check its exit status and the last line of its stderr
+expect() {
+    local name=$1 status=$2 message=$3
+    shift 3
+    timeout 10 "$@" > /dev/null 2> "$dir/err"
+    local actual=$?
+    if [ $actual -ne $status ] || 
+	    [ "$(tail -n 1 "$dir/err")" != "$message" ]; then
+        echo "FAIL $name: status $actual, $(tail -n 1 "$dir/err")"
+        failed=1
+    else
+        echo "ok $name"
+    fi
+}
+
+# compiled given directly and intact
+expect "compiled deck and path" 0 "" \
+	./2310sim "$dir/deck.bin" "$dir/path.bin" 1 A B
+
+expect "compiled path offered to players" 0 "" \
+	./2310dealer -c "$dir/deck.bin" "$dir/path.bin" ./2310A ./2310B
+
+# a deck cut short
+head -c 20 "$dir/deck.bin" > "$dir/short.bin"
+expect "truncated deck (sim)" 2 "Error reading deck" \
+	./2310sim "$dir/short.bin" "$dir/path.bin" 1 A B
+expect "truncated deck (dealer)" 2 "Error reading deck" \
+	./2310dealer "$dir/short.bin" "$dir/path.bin" ./2310A ./2310B
+
+# a path that claims far more sites than it holds
+cp "$dir/path.bin" "$dir/huge.bin"
+printf '\x00\xe1\xf5\x05' | 
+	dd of="$dir/huge.bin" bs=1 seek=8 conv=notrunc 2> /dev/null
+expect "oversized path (sim)" 3 "Error reading path" \
+	./2310sim "$dir/deck.bin" "$dir/huge.bin" 1 A B
+expect "oversized path (dealer)" 3 "Error reading path" \
+	./2310dealer "$dir/deck.bin" "$dir/huge.bin" ./2310A ./2310B
+
+# a compiled path next to its text that has been damaged is ignored
+cp "$dir/huge.bin" "$dir/path.bin"
+expect "damaged compiled path beside text" 0 "" \
+	./2310sim "$dir/deck" "$dir/path" 1 A B
+
+exit $failed
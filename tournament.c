@@ -0,0 +1,248 @@
+#include "tournament.h"
+
+/*
+ * Add a task to the bottom of a deque
+ * Only the owner of the deque may push
+ * */
+void push_task(Deque* deque, Task task) {
+    long bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED);
+
+    deque->tasks[bottom % deque->capacity] = task;
+    __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELEASE);
+}
+
+/*
+ * Take the most recently pushed task from the bottom of a deque
+ * Only the owner of the deque may pop
+ * Return true if a task was taken and false if the deque was empty
+ * */
+bool pop_task(Deque* deque, Task* task) {
+    long bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n(&deque->bottom, bottom, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long top = __atomic_load_n(&deque->top, __ATOMIC_RELAXED);
+
+    if (top > bottom) {
+        __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+        return false;
+    }
+
+    *task = deque->tasks[bottom % deque->capacity];
+    if (top == bottom) {
+        // Last task, race any thieves for it
+        bool won = __atomic_compare_exchange_n(&deque->top, &top, top + 1,
+		false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+        __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+        return won;
+    }
+
+    return true;
+}
+
+/*
+ * Take the oldest task from the top of another worker's deque
+ * Return true if a task was stolen and false if the deque was empty or
+ * another thread took the task first
+ * */
+bool steal_task(Deque* deque, Task* task) {
+    long top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long bottom = __atomic_load_n(&deque->bottom, __ATOMIC_ACQUIRE);
+
+    if (top >= bottom) {
+        return false;
+    }
+
+    *task = deque->tasks[top % deque->capacity];
+    return __atomic_compare_exchange_n(&deque->top, &top, top + 1, false,
+	    __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+}
+
+/*
+ * Check to see if any worker still has tasks waiting in its deque
+ * Return true if there is work left to steal and false otherwise
+ * */
+bool work_remaining(Tournament* tournament) {
+    int i;
+
+    for (i = 0; i < tournament->numWorkers; i++) {
+        Deque* deque = &tournament->workers[i].deque;
+        if (__atomic_load_n(&deque->top, __ATOMIC_ACQUIRE) <
+		__atomic_load_n(&deque->bottom, __ATOMIC_ACQUIRE)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+ * Allocate a zeroed block that starts on a cache line and fills whole cache
+ * lines, so that nothing else can share a line with it
+ * Exit if the block could not be allocated
+ * */
+void* cache_aligned(size_t size) {
+    void* block;
+
+    size = (size + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+    if (posix_memalign(&block, CACHE_LINE, size)) {
+        fprintf(stderr, "Error starting tournament\n");
+        exit(5);
+    }
+    memset(block, 0, size);
+
+    return block;
+}
+
+/*
+ * Split every job into tasks of at most chunk games and deal them out to
+ * the deques of the workers in turn
+ * */
+void initialise_tournament(Tournament* tournament, Job* jobs, int numJobs,
+	int numWorkers, int chunk) {
+    int i, j, games, next = 0;
+    long tasks = 0;
+
+    for (j = 0; j < numJobs; j++) {
+        tasks += (jobs[j].games + chunk - 1) / chunk;
+    }
+
+    tournament->jobs = jobs;
+    tournament->numJobs = numJobs;
+    tournament->numWorkers = numWorkers;
+    tournament->chunk = chunk;
+    if (posix_memalign((void**)&tournament->workers, CACHE_LINE,
+	    sizeof(Worker) * numWorkers)) {
+        fprintf(stderr, "Error starting tournament\n");
+        exit(5);
+    }
+
+    for (i = 0; i < numWorkers; i++) {
+        Worker* worker = &tournament->workers[i];
+        memset(worker, 0, sizeof(Worker));
+        worker->tournament = tournament;
+        worker->index = i;
+        worker->seed = i + 1;
+        worker->deque.capacity = tasks / numWorkers + 1;
+        worker->deque.tasks = (Task*)malloc(sizeof(Task) *
+		worker->deque.capacity);
+        worker->engines = (Engine**)calloc(numJobs, sizeof(Engine*));
+        // Results are written after every game, so keep each worker's on 
+        // cache lines of their own
+        worker->results = (Result*)cache_aligned(sizeof(Result) * numJobs);
+        for (j = 0; j < numJobs; j++) {
+            worker->results[j].wins = (long long*)cache_aligned(
+		    sizeof(long long) * jobs[j].numPlayers);
+            worker->results[j].points = (long long*)cache_aligned(
+		    sizeof(long long) * jobs[j].numPlayers);
+        }
+    }
+
+    for (j = 0; j < numJobs; j++) {
+        for (games = jobs[j].games; games > 0; games -= chunk) {
+            Task task = {j, games < chunk ? games : chunk};
+            push_task(&tournament->workers[next].deque, task);
+            next = (next + 1) % numWorkers;
+        }
+    }
+}
+
+/*
+ * Play the games of a task on the worker's own engine for that job and add
+ * the outcome to the worker's own results
+ * */
+void execute_task(Worker* worker, Task* task) {
+    Job* job = &worker->tournament->jobs[task->job];
+    Result* result = &worker->results[task->job];
+    int g, i;
+
+    if (!worker->engines[task->job]) {
+        Engine* engine = (Engine*)malloc(sizeof(Engine));
+        initialise_engine(engine, job->deckBuffer, job->pathBuffer,
+		job->seats, job->numPlayers);
+        worker->engines[task->job] = engine;
+    }
+    Engine* engine = worker->engines[task->job];
+    Players* players = &engine->game.players;
+
+    for (g = 0; g < task->games; g++) {
+        run_game(engine);
+        int best = 0;
+        for (i = 0; i < job->numPlayers; i++) {
+            result->points[i] += players->points[i];
+            if (players->points[i] > players->points[best]) {
+                best = i;
+            }
+        }
+        result->wins[best]++;
+    }
+    result->games += task->games;
+    worker->executed++;
+}
+
+/*
+ * Main loop of a worker thread
+ * Work through the worker's own deque, then steal from randomly chosen
+ * victims until no deque has any tasks left
+ * */
+void* run_worker(void* arg) {
+    Worker* worker = (Worker*)arg;
+    Tournament* tournament = worker->tournament;
+    Task task;
+
+    while (1) {
+        while (pop_task(&worker->deque, &task)) {
+            execute_task(worker, &task);
+        }
+        if (tournament->numWorkers == 1 || !work_remaining(tournament)) {
+            break;
+        }
+
+        int victim = rand_r(&worker->seed) % tournament->numWorkers;
+        if (victim != worker->index &&
+		steal_task(&tournament->workers[victim].deque, &task)) {
+            worker->stolen++;
+            execute_task(worker, &task);
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Start one thread per worker and wait for all of the tasks to finish
+ * */
+void run_tournament(Tournament* tournament) {
+    int i;
+
+    for (i = 0; i < tournament->numWorkers; i++) {
+        if (pthread_create(&tournament->workers[i].thread, NULL, run_worker,
+		&tournament->workers[i])) {
+            fprintf(stderr, "Error starting tournament\n");
+            exit(5);
+        }
+    }
+
+    for (i = 0; i < tournament->numWorkers; i++) {
+        pthread_join(tournament->workers[i].thread, NULL);
+    }
+}
+
+/*
+ * Add up the results of every worker once they have all finished
+ * totals must hold one zeroed result per job
+ * */
+void merge_results(Tournament* tournament, Result* totals) {
+    int i, j, k;
+
+    for (i = 0; i < tournament->numWorkers; i++) {
+        for (j = 0; j < tournament->numJobs; j++) {
+            Result* result = &tournament->workers[i].results[j];
+            totals[j].games += result->games;
+            for (k = 0; k < tournament->jobs[j].numPlayers; k++) {
+                totals[j].wins[k] += result->wins[k];
+                totals[j].points[k] += result->points[k];
+            }
+        }
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+#include "common.h"
+#include "engine.h"
+#include <pthread.h>
+
+#define CACHE_LINE 64
+
+/*
+ * One line of a tournament: a number of games on a deck and path between
+ * a fixed seating of strategies
+ * */
+typedef struct {
+    char* deckFile;
+    char* pathFile;
+    char* deckBuffer;
+    char* pathBuffer;
+    Strategy* seats;
+    char** seatNames;
+    int numPlayers;
+    int games;
+} Job;
+
+/*
+ * A slice of the games of one job, the unit of work that is stolen
+ * */
+typedef struct {
+    int job;
+    int games;
+} Task;
+
+/*
+ * Chase-Lev work-stealing deque
+ * The owner pushes and pops at the bottom, thieves steal from the top
+ * */
+typedef struct {
+    long top __attribute__((aligned(CACHE_LINE)));
+    long bottom __attribute__((aligned(CACHE_LINE)));
+    Task* tasks;
+    long capacity;
+} Deque;
+
+/*
+ * Totals gathered by a single worker for one job
+ * */
+typedef struct {
+    long long games;
+    long long* wins;
+    long long* points;
+} Result;
+
+typedef struct Tournament Tournament;
+
+/*
+ * The private state of a worker thread: its deque, its engines and its own
+ * results, which are only merged once every worker has finished
+ * */
+typedef struct {
+    Deque deque;
+    Tournament* tournament;
+    Engine** engines;
+    Result* results;
+    pthread_t thread;
+    int index;
+    unsigned seed;
+    long long executed;
+    long long stolen;
+} __attribute__((aligned(CACHE_LINE))) Worker;
+
+struct Tournament {
+    Job* jobs;
+    int numJobs;
+    Worker* workers;
+    int numWorkers;
+    int chunk;
+};
+
+void* cache_aligned(size_t size);
+void push_task(Deque* deque, Task task);
+bool pop_task(Deque* deque, Task* task);
+bool steal_task(Deque* deque, Task* task);
+void initialise_tournament(Tournament* tournament, Job* jobs, int numJobs,
+	int numWorkers, int chunk);
+void run_tournament(Tournament* tournament);
+void merge_results(Tournament* tournament, Result* totals);
+
+#endif
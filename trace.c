@@ -0,0 +1,204 @@
+#include "trace.h"
+#include "compiled.h"
+#include <errno.h>
+
+/*
+ * Create a trace file for a game and write its header, the path, the deck 
+ * and the program of every seat
+ * Return the trace or NULL if the file could not be created
+ * */
+Trace* open_trace(char* fileName, Game* game, char** seats) {
+    int i, fd = open(fileName, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 
+	    0644);
+    char padding[TRACE_ALIGN] = {0};
+
+    if (fd < 0) {
+        return NULL;
+    }
+    Trace* trace = (Trace*)malloc(sizeof(Trace));
+    trace->fd = fd;
+    trace->buffer = (char*)malloc(TRACE_BUFFER_SIZE);
+    trace->used = 0;
+    trace->failed = false;
+
+    TraceHeader header;
+    memset(&header, 0, sizeof(TraceHeader));
+    memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    header.version = TRACE_VERSION;
+    header.numPlayers = game->numPlayers;
+    header.pathSize = game->pathSize;
+    header.deckSize = game->deckSize;
+    for (i = 0; i < game->numPlayers; i++) {
+        header.seatSize += strlen(seats[i]) + 1;
+    }
+    long long size = sizeof(TraceHeader) + game->pathSize * 
+	    (sizeof(int) + sizeof(unsigned char)) + game->deckSize + 
+	    header.seatSize;
+    header.recordsOffset = (size + TRACE_ALIGN - 1) / TRACE_ALIGN * 
+	    TRACE_ALIGN;
+
+    trace_write(trace, &header, sizeof(TraceHeader));
+    for (i = 0; i < game->pathSize; i++) {
+        trace_write(trace, &game->sites[i].limit, sizeof(int));
+    }
+    trace_write(trace, game->types, game->pathSize);
+    trace_write(trace, game->deck, game->deckSize);
+    for (i = 0; i < game->numPlayers; i++) {
+        trace_write(trace, seats[i], strlen(seats[i]) + 1);
+    }
+    trace_write(trace, padding, header.recordsOffset - size);
+
+    return trace;
+}
+
+/*
+ * Add bytes to the trace, writing the buffer out whenever it fills
+ * */
+void trace_write(Trace* trace, void* data, int size) {
+    while (size > 0) {
+        if (trace->used == TRACE_BUFFER_SIZE) {
+            flush_trace(trace);
+        }
+        int part = TRACE_BUFFER_SIZE - trace->used;
+        if (part > size) {
+            part = size;
+        }
+        memcpy(trace->buffer + trace->used, data, part);
+        trace->used += part;
+        data = (char*)data + part;
+        size -= part;
+    }
+}
+
+/*
+ * Add a record of one turn to the trace
+ * move holds the points, money and card that the turn gave the player
+ * Does nothing if there is no trace
+ * */
+void trace_turn(Trace* trace, int id, int site, int* move) {
+    if (!trace) {
+        return;
+    }
+    if (trace->used + sizeof(TraceRecord) > TRACE_BUFFER_SIZE) {
+        flush_trace(trace);
+    }
+    TraceRecord* record = (TraceRecord*)(trace->buffer + trace->used);
+    record->id = id;
+    record->site = site;
+    record->points = move[0];
+    record->money = move[1];
+    record->card = move[2];
+    memset(record->reserved, 0, sizeof(record->reserved));
+    trace->used += sizeof(TraceRecord);
+}
+
+/*
+ * Write out everything that has been added to the trace
+ * Return true on success or false if any write to the trace has failed
+ * */
+bool flush_trace(Trace* trace) {
+    int written = 0;
+
+    while (!trace->failed && written < trace->used) {
+        int result = write(trace->fd, trace->buffer + written, 
+		trace->used - written);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        } else if (result <= 0) {
+            trace->failed = true;
+        } else {
+            written += result;
+        }
+    }
+    trace->used = 0;
+
+    return !trace->failed;
+}
+
+/*
+ * Write out the rest of the trace and close it
+ * Return true on success or false if any write to the trace has failed
+ * */
+bool close_trace(Trace* trace) {
+    bool written = flush_trace(trace);
+
+    if (close(trace->fd) < 0) {
+        written = false;
+    }
+    free(trace->buffer);
+    free(trace);
+
+    return written;
+}
+
+/*
+ * Map a trace written by open_trace into memory and check that its header 
+ * agrees with the size of the file
+ * Set length to the size of the file
+ * Return the header of the trace or NULL if it cannot be read or is not a 
+ * trace
+ * */
+TraceHeader* map_trace(char* fileName, long long* length) {
+    char* buffer = map_file(fileName, length);
+    TraceHeader* header = (TraceHeader*)buffer;
+
+    if (!buffer) {
+        return NULL;
+    }
+    if (*length < sizeof(TraceHeader) || 
+	    memcmp(header->magic, TRACE_MAGIC, sizeof(header->magic)) || 
+	    header->version != TRACE_VERSION || header->numPlayers < 1 || 
+	    header->pathSize < 2 || header->deckSize < 1 || 
+	    header->seatSize < header->numPlayers) {
+        unmap_file(buffer, *length);
+        return NULL;
+    }
+    long long size = sizeof(TraceHeader) + (long long)header->pathSize * 
+	    (sizeof(int) + sizeof(unsigned char)) + header->deckSize + 
+	    header->seatSize;
+    if (header->recordsOffset < size || header->recordsOffset > *length || 
+	    header->recordsOffset % TRACE_ALIGN || 
+	    (*length - header->recordsOffset) % sizeof(TraceRecord) || 
+	    trace_seats(header)[header->seatSize - 1] != '\0') {
+        unmap_file(buffer, *length);
+        return NULL;
+    }
+
+    return header;
+}
+
+/*
+ * Return the limit of every site of a trace
+ * */
+int* trace_limits(TraceHeader* header) {
+    return (int*)(header + 1);
+}
+
+/*
+ * Return the type of every site of a trace
+ * */
+unsigned char* trace_types(TraceHeader* header) {
+    return (unsigned char*)(trace_limits(header) + header->pathSize);
+}
+
+/*
+ * Return the cards of the deck of a trace
+ * */
+char* trace_deck(TraceHeader* header) {
+    return (char*)(trace_types(header) + header->pathSize);
+}
+
+/*
+ * Return the program of the first seat of a trace, with the program of 
+ * each following seat after the '\0' that ends the one before
+ * */
+char* trace_seats(TraceHeader* header) {
+    return trace_deck(header) + header->deckSize;
+}
+
+/*
+ * Return the record of the first turn of a trace
+ * */
+TraceRecord* trace_records(TraceHeader* header) {
+    return (TraceRecord*)((char*)header + header->recordsOffset);
+}
@@ -0,0 +1,54 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "common.h"
+
+#define TRACE_MAGIC "\x7f" "23T"
+#define TRACE_VERSION 1
+#define TRACE_ALIGN 8
+
+/*
+ * Header of a binary game trace
+ * It is followed by the limit of every site, the type of every site, the 
+ * cards of the deck and the program of every seat, each ending in '\0'
+ * The records of the turns start at recordsOffset and run to the end of 
+ * the file
+ * */
+typedef struct {
+    char magic[4];
+    unsigned short version;
+    unsigned short reserved;
+    int numPlayers;
+    int pathSize;
+    int deckSize;
+    int seatSize;
+    long long recordsOffset;
+} TraceHeader;
+
+/*
+ * One turn of a traced game: the player who moved, the site they moved to 
+ * and the points, money and card that the move gave them, as handle_move 
+ * reports them
+ * */
+typedef struct {
+    int id;
+    int site;
+    int points;
+    int money;
+    signed char card;
+    unsigned char reserved[3];
+} TraceRecord;
+
+Trace* open_trace(char* fileName, Game* game, char** seats);
+void trace_write(Trace* trace, void* data, int size);
+void trace_turn(Trace* trace, int id, int site, int* move);
+bool flush_trace(Trace* trace);
+bool close_trace(Trace* trace);
+TraceHeader* map_trace(char* fileName, long long* length);
+int* trace_limits(TraceHeader* header);
+unsigned char* trace_types(TraceHeader* header);
+char* trace_deck(TraceHeader* header);
+char* trace_seats(TraceHeader* header);
+TraceRecord* trace_records(TraceHeader* header);
+
+#endif